@@ -0,0 +1,16 @@
+#!/usr/bin/bash
+
+./build.sh
+SOURCE_FILES=$(find ./benchmarks/ -name "*.c")
+mkdir build -p
+gcc -O2 $SOURCE_FILES ./tests/include/scrutiny.c ./build/oolong.a -pthread -o build/bench
+
+# Human readable results go to stdout and parsable "name:seconds" lines to the
+# given file, build/benchmarks.txt by default, for comparing between commits.
+./build/bench "${1:-build/benchmarks.txt}"
+
+if [ "$?" != "0" ]; then
+    exit 1
+fi
+
+rm build/bench
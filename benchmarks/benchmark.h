@@ -0,0 +1,19 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <time.h>
+#include "../tests/include/scrutiny.h"
+
+/*
+ * Records the time since 'start' under the given name rather than the calling
+ * function's, so one benchmark function can report a result per parameter.
+ * The name must outlive the benchmark results, a string literal is simplest.
+ */
+#define benchmark_report(name, start) scrutiny_report_benchmark_time(clock() - (start), __FILE__, name, __LINE__)
+
+#endif // BENCHMARK_H
@@ -0,0 +1,186 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stdio.h>
+#include "element_benchmarks.h"
+#include "../oolong/oolong.h"
+
+/* Characters rendered per case, shorter content is rendered more times. */
+#define RENDERED_CHARACTERS 262144
+
+#define SELECT_ELEMENTS 100000
+#define SELECT_STEPS 1000
+
+#define SCREEN_COLUMNS 120
+#define SCREEN_ROWS 40
+
+struct render_case_s
+{
+	size_t length;
+	oolong_alignment_t alignment;
+	const char* name;
+};
+
+struct print_case_s
+{
+	size_t elements;
+	bool render_direct;
+	const char* name;
+};
+
+static const struct render_case_s render_cases[] =
+{
+	{ 16,	OOLONG_ALIGN_LEFT,		"element_render_left_16" },
+	{ 16,	OOLONG_ALIGN_CENTER,	"element_render_center_16" },
+	{ 16,	OOLONG_ALIGN_RIGHT,		"element_render_right_16" },
+	{ 256,	OOLONG_ALIGN_LEFT,		"element_render_left_256" },
+	{ 256,	OOLONG_ALIGN_CENTER,	"element_render_center_256" },
+	{ 256,	OOLONG_ALIGN_RIGHT,		"element_render_right_256" },
+	{ 4096,	OOLONG_ALIGN_LEFT,		"element_render_left_4096" },
+	{ 4096,	OOLONG_ALIGN_CENTER,	"element_render_center_4096" },
+	{ 4096,	OOLONG_ALIGN_RIGHT,		"element_render_right_4096" }
+};
+
+static const struct print_case_s print_cases[] =
+{
+	{ 10,		false,	"stack_view_print_10" },
+	{ 1000,		false,	"stack_view_print_1k" },
+	{ 100000,	false,	"stack_view_print_100k" },
+	{ 10,		true,	"stack_view_print_10_direct" },
+	{ 1000,		true,	"stack_view_print_1k_direct" },
+	{ 100000,	true,	"stack_view_print_100k_direct" }
+};
+
+static wchar_t* create_content(size_t length)
+{
+	wchar_t* content = malloc((length + 1) * sizeof *content);
+
+	for (size_t index = 0; index < length; index++)
+		content[index] = index % 6 == 5 ? L' ' : L'a' + index % 26;
+
+	content[length] = L'\0';
+	return content;
+}
+
+static oolong_label_t* create_label(wchar_t* content, oolong_alignment_t alignment, unsigned int width)
+{
+	oolong_style_set_t* style = oolong_style_set_create();
+	oolong_style_set_add(&style, OOLONG_STYLE_BOLD);
+
+	oolong_label_options_t options =
+	{
+		.identifier = 0,
+		.alignment = alignment,
+		.padding = 2,
+		.width = width,
+		.style = style,
+		.content = content
+	};
+
+	return oolong_label_create(&options);
+}
+
+SCRUTINY_BENCHMARK element_render_benchmark(void)
+{
+	oolong_set_locale();
+
+	for (size_t index = 0; index < sizeof render_cases / sizeof *render_cases; index++)
+	{
+		const struct render_case_s* render_case = &render_cases[index];
+		wchar_t* content = create_content(render_case->length);
+		oolong_label_t* label = create_label(content, render_case->alignment, render_case->length + 16);
+
+		clock_t start = clock();
+
+		/* Marked dirty so that every render does the work rather than reusing the last string. */
+		for (size_t render = 0; render < RENDERED_CHARACTERS / render_case->length; render++)
+		{
+			oolong_element_mark_dirty((oolong_element_t*)label);
+			oolong_element_render_string((oolong_element_t*)label);
+		}
+
+		benchmark_report(render_case->name, start);
+
+		oolong_label_destroy(label);
+		free(content);
+	}
+}
+
+SCRUTINY_BENCHMARK element_select_benchmark(void)
+{
+	oolong_element_t* elements = calloc(SELECT_ELEMENTS, sizeof *elements);
+	oolong_element_t** element_pointers = malloc((SELECT_ELEMENTS + 1) * sizeof *element_pointers);
+
+	/* Every other element is selectable, as with labels between buttons. */
+	for (size_t index = 0; index < SELECT_ELEMENTS; index++)
+	{
+		bool selectable = index % 2 == 0;
+		elements[index].supported_states = OOLONG_ELEMENT_STATE_NORMAL | (selectable ? OOLONG_ELEMENT_STATE_SELECTED : 0);
+		elements[index].state = OOLONG_ELEMENT_STATE_NORMAL;
+		element_pointers[index] = &elements[index];
+	}
+
+	element_pointers[SELECT_ELEMENTS] = NULL;
+	elements[0].state = OOLONG_ELEMENT_STATE_SELECTED;
+
+	clock_t start = clock();
+
+	for (size_t step = 0; step < SELECT_STEPS; step++)
+		oolong_element_select_next(element_pointers);
+
+	benchmark_report("element_select_next_100k", start);
+	start = clock();
+
+	for (size_t step = 0; step < SELECT_STEPS; step++)
+		oolong_element_select_previous(element_pointers);
+
+	benchmark_report("element_select_previous_100k", start);
+
+	free(element_pointers);
+	free(elements);
+}
+
+SCRUTINY_BENCHMARK stack_view_print_benchmark(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(SCREEN_COLUMNS, SCREEN_ROWS);
+
+	FILE* null_file = fopen("/dev/null", "w");
+	wchar_t* content = create_content(48);
+
+	for (size_t index = 0; index < sizeof print_cases / sizeof *print_cases; index++)
+	{
+		const struct print_case_s* print_case = &print_cases[index];
+		oolong_element_t** elements = malloc((print_case->elements + 1) * sizeof *elements);
+
+		for (size_t element = 0; element < print_case->elements; element++)
+			elements[element] = (oolong_element_t*)create_label(content, OOLONG_ALIGN_CENTER, 0);
+
+		elements[print_case->elements] = NULL;
+
+		oolong_stack_view_t view =
+		{
+			.elements = elements,
+			.alignment = OOLONG_ALIGN_CENTER,
+			.margin_sides = 4,
+			.element_gap = 1,
+			.render_direct = print_case->render_direct
+		};
+
+		clock_t start = clock();
+		oolong_stack_view_print(&view, null_file);
+		fflush(null_file);
+		benchmark_report(print_case->name, start);
+
+		for (size_t element = 0; element < print_case->elements; element++)
+			oolong_label_destroy((oolong_label_t*)elements[element]);
+
+		free(elements);
+	}
+
+	free(content);
+	fclose(null_file);
+	oolong_set_screen_dimensions(0, 0);
+}
@@ -0,0 +1,15 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef ELEMENT_BENCHMARKS_H
+#define ELEMENT_BENCHMARKS_H
+
+#include "benchmark.h"
+
+SCRUTINY_BENCHMARK element_render_benchmark(void);
+SCRUTINY_BENCHMARK element_select_benchmark(void);
+SCRUTINY_BENCHMARK stack_view_print_benchmark(void);
+
+#endif // ELEMENT_BENCHMARKS_H
@@ -0,0 +1,136 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "input_benchmarks.h"
+#include "../oolong/oolong.h"
+
+#define TYPED_CHARACTERS 5000
+
+/* Escape sequences written to the pipe at a time, kept well under its capacity. */
+#define DECODED_BATCH 1024
+#define DECODED_BATCHES 64
+
+SCRUTINY_BENCHMARK text_box_typing_benchmark(void)
+{
+	oolong_set_locale();
+
+	oolong_text_box_options_t options =
+	{
+		.display_text = L"",
+		.state = OOLONG_ELEMENT_STATE_ACTIVE,
+		.style_normal = oolong_style_set_create(),
+		.alignment = OOLONG_ALIGN_LEFT
+	};
+
+	oolong_text_box_t* text_box = oolong_text_box_create(&options);
+	clock_t start = clock();
+
+	/* Typing renders after every key as an application redrawing would. */
+	for (size_t index = 0; index < TYPED_CHARACTERS; index++)
+	{
+		oolong_text_box_register_keystroke(text_box, index % 8 == 7 ? KEY_SPACE : KEY_LOWERCASE_A + index % 26);
+		oolong_element_render_string((oolong_element_t*)text_box);
+	}
+
+	benchmark_report("text_box_typing", start);
+	start = clock();
+
+	for (size_t index = 0; index < TYPED_CHARACTERS; index++)
+	{
+		oolong_text_box_register_keystroke(text_box, KEY_BACKSPACE);
+		oolong_element_render_string((oolong_element_t*)text_box);
+	}
+
+	benchmark_report("text_box_backspacing", start);
+	oolong_text_box_destroy(text_box);
+}
+
+SCRUTINY_BENCHMARK key_decoding_benchmark(void)
+{
+	static const char* sequences[] = { "\e[A", "\e[B", "\e[C", "\e[D", "\e[H", "\e[F" };
+	char batch[DECODED_BATCH * 3];
+	int pipe_descriptors[2];
+
+	for (size_t index = 0; index < DECODED_BATCH; index++)
+		memcpy(&batch[index * 3], sequences[index % 6], 3);
+
+	/* Keys are read from standard input, so it is swapped for a pipe while decoding. */
+	int original_input = dup(STDIN_FILENO);
+
+	if (pipe(pipe_descriptors) != 0 || dup2(pipe_descriptors[0], STDIN_FILENO) == -1)
+		return;
+
+	clock_t start = clock();
+
+	for (size_t batch_index = 0; batch_index < DECODED_BATCHES; batch_index++)
+	{
+		if (write(pipe_descriptors[1], batch, sizeof batch) != sizeof batch)
+			break;
+
+		for (size_t index = 0; index < DECODED_BATCH; index++)
+			oolong_keyboard_get_key();
+	}
+
+	benchmark_report("key_decoding_escapes", start);
+
+	dup2(original_input, STDIN_FILENO);
+	close(original_input);
+	close(pipe_descriptors[0]);
+	close(pipe_descriptors[1]);
+}
+
+/*
+ * Replays a recorded session as fast as possible through the real decoder. A
+ * real session recorded with oolong_keyboard_record_start() can be replayed by
+ * setting OOLONG_BENCH_SESSION to its path, otherwise one is recorded here.
+ */
+SCRUTINY_BENCHMARK key_replay_benchmark(void)
+{
+	const char* session_path = getenv("OOLONG_BENCH_SESSION");
+	FILE* session = session_path != NULL ? fopen(session_path, "rb") : tmpfile();
+	int pipe_descriptors[2];
+
+	if (session == NULL)
+		return;
+
+	int original_input = dup(STDIN_FILENO);
+
+	if (pipe(pipe_descriptors) != 0 || dup2(pipe_descriptors[0], STDIN_FILENO) == -1)
+		return;
+
+	if (session_path == NULL)
+	{
+		oolong_keyboard_record_start(session);
+
+		for (size_t index = 0; index < DECODED_BATCH; index++)
+		{
+			if (write(pipe_descriptors[1], index % 2 ? "\e[B" : "j", index % 2 ? 3 : 1) < 1)
+				break;
+
+			oolong_keyboard_get_key();
+		}
+
+		oolong_keyboard_record_stop();
+		rewind(session);
+	}
+
+	/* Reading past the end of the session finds the pipe closed rather than waiting. */
+	close(pipe_descriptors[1]);
+	oolong_keyboard_replay_start(session, OOLONG_REPLAY_FAST);
+	clock_t start = clock();
+
+	while (oolong_keyboard_is_replaying())
+		oolong_keyboard_get_key();
+
+	benchmark_report("key_replay_session", start);
+
+	dup2(original_input, STDIN_FILENO);
+	close(original_input);
+	close(pipe_descriptors[0]);
+	fclose(session);
+}
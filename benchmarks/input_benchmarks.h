@@ -0,0 +1,15 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef INPUT_BENCHMARKS_H
+#define INPUT_BENCHMARKS_H
+
+#include "benchmark.h"
+
+SCRUTINY_BENCHMARK text_box_typing_benchmark(void);
+SCRUTINY_BENCHMARK key_decoding_benchmark(void);
+SCRUTINY_BENCHMARK key_replay_benchmark(void);
+
+#endif // INPUT_BENCHMARKS_H
@@ -0,0 +1,39 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stdio.h>
+#include "../tests/include/scrutiny.h"
+#include "element_benchmarks.h"
+#include "input_benchmarks.h"
+
+/* Times every benchmark is run, results are averaged over the runs. */
+#define BENCHMARK_RUNS 5
+
+int main(int argc, char** argv)
+{
+    scrutiny_benchmark_t benchmarks[] =
+    {
+        element_render_benchmark,
+        element_select_benchmark,
+        stack_view_print_benchmark,
+        text_box_typing_benchmark,
+        key_decoding_benchmark,
+        key_replay_benchmark,
+        NULL
+    };
+
+    scrutiny_run_benchmarks_n_times(benchmarks, BENCHMARK_RUNS);
+    scrutiny_output_benchmark_results(stdout);
+
+    FILE* parsable_file = argc > 1 ? fopen(argv[1], "w") : stdout;
+
+    if (parsable_file == NULL || scrutiny_output_benchmark_results_parsable(parsable_file) != 0)
+        exit(EXIT_FAILURE);
+
+    if (parsable_file != stdout)
+        fclose(parsable_file);
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,259 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <string.h>
+#include <stdalign.h>
+#include "memory.h"
+#include "arena.h"
+
+#define SIZE_CLASSES (__builtin_ctz(OOLONG_ARENA_LARGEST_CLASS) - __builtin_ctz(OOLONG_ARENA_SMALLEST_CLASS) + 1)
+#define ALIGNMENT alignof(max_align_t)
+
+typedef struct block_s block_t;
+typedef struct free_slot_s free_slot_t;
+typedef struct tracked_s tracked_t;
+
+/* Blocks and allocations too large for a size class are both kept on lists of these. */
+struct block_s
+{
+	block_t* next;
+	size_t size;
+	alignas(ALIGNMENT) char memory[];
+};
+
+struct free_slot_s
+{
+	free_slot_t* next;
+};
+
+struct tracked_s
+{
+	void* object;
+	oolong_arena_release_t release;
+};
+
+struct oolong_arena_s
+{
+	size_t block_size;
+	size_t heap_size;					/* Bytes taken from the heap. */
+	block_t* blocks;					/* Blocks being bumped through, the first being current. */
+	size_t block_used;					/* Bytes used of the current block. */
+	block_t* large;						/* Allocations larger than any size class. */
+	free_slot_t* free_slots[SIZE_CLASSES];
+	tracked_t* tracked;
+	size_t tracked_length;
+	size_t tracked_capacity;
+};
+
+/*
+ * Gets the size class of an allocation, or SIZE_CLASSES if too large for any.
+ */
+static unsigned int size_class(size_t size)
+{
+	if (size <= OOLONG_ARENA_SMALLEST_CLASS)
+		return 0;
+
+	if (size > OOLONG_ARENA_LARGEST_CLASS)
+		return SIZE_CLASSES;
+
+	return (64 - __builtin_clzll(size - 1)) - __builtin_ctz(OOLONG_ARENA_SMALLEST_CLASS);
+}
+
+static size_t class_size(unsigned int class)
+{
+	return (size_t)OOLONG_ARENA_SMALLEST_CLASS << class;
+}
+
+static block_t* heap_block(oolong_arena_t* arena, block_t** list, size_t size)
+{
+	block_t* block = oolong_memory_allocate(sizeof *block + size);
+
+	if (block == NULL)
+		return NULL;
+
+	block->next = *list;
+	block->size = size;
+	*list = block;
+	arena->heap_size += sizeof *block + size;
+	return block;
+}
+
+oolong_arena_t* oolong_arena_create(size_t block_size)
+{
+	oolong_arena_t* arena = oolong_memory_allocate_zeroed(1, sizeof *arena);
+
+	if (arena == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+		return NULL;
+	}
+
+	block_size = block_size == 0 ? OOLONG_ARENA_DEFAULT_BLOCK_SIZE : block_size;
+	arena->block_size = block_size < OOLONG_ARENA_LARGEST_CLASS ? OOLONG_ARENA_LARGEST_CLASS : block_size;
+	return arena;
+}
+
+oolong_error_t oolong_arena_destroy(oolong_arena_t* arena)
+{
+	if (arena == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	for (size_t index = 0; index < arena->tracked_length; index++)
+		if (arena->tracked[index].object != NULL)
+			arena->tracked[index].release(arena->tracked[index].object);
+
+	block_t* lists[] = { arena->blocks, arena->large };
+
+	for (size_t list = 0; list < 2; list++)
+	{
+		for (block_t* block = lists[list]; block != NULL;)
+		{
+			block_t* next = block->next;
+			oolong_memory_free(block);
+			block = next;
+		}
+	}
+
+	oolong_memory_free(arena->tracked);
+	oolong_memory_free(arena);
+	return OOLONG_ERROR_NONE;
+}
+
+void* oolong_arena_allocate(oolong_arena_t* arena, size_t size)
+{
+	if (arena == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return NULL;
+	}
+
+	unsigned int class = size_class(size);
+
+	if (class == SIZE_CLASSES)
+	{
+		block_t* block = heap_block(arena, &arena->large, size);
+		return block == NULL ? NULL : block->memory;
+	}
+
+	if (arena->free_slots[class] != NULL)
+	{
+		free_slot_t* slot = arena->free_slots[class];
+		arena->free_slots[class] = slot->next;
+		return slot;
+	}
+
+	/* Size classes are all multiples of the alignment so bumping keeps every slot aligned. */
+	size_t slot_size = class_size(class);
+
+	if (arena->blocks == NULL || arena->block_used + slot_size > arena->blocks->size)
+	{
+		if (heap_block(arena, &arena->blocks, arena->block_size) == NULL)
+			return NULL;
+
+		arena->block_used = 0;
+	}
+
+	void* slot = &arena->blocks->memory[arena->block_used];
+	arena->block_used += slot_size;
+	return slot;
+}
+
+void* oolong_arena_reallocate(oolong_arena_t* arena, void* pointer, size_t old_size, size_t size)
+{
+	if (arena == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return NULL;
+	}
+
+	unsigned int old_class = size_class(old_size);
+
+	/* Still fits in the same slot. */
+	if (pointer != NULL && old_class < SIZE_CLASSES && size <= class_size(old_class))
+		return pointer;
+
+	void* new_pointer = oolong_arena_allocate(arena, size);
+
+	if (new_pointer == NULL)
+		return NULL;
+
+	if (pointer != NULL)
+	{
+		memcpy(new_pointer, pointer, old_size < size ? old_size : size);
+		oolong_arena_free(arena, pointer, old_size);
+	}
+
+	return new_pointer;
+}
+
+void oolong_arena_free(oolong_arena_t* arena, void* pointer, size_t size)
+{
+	if (arena == NULL || pointer == NULL)
+		return;
+
+	unsigned int class = size_class(size);
+
+	/* Large allocations stay on their list until the arena is destroyed. */
+	if (class == SIZE_CLASSES)
+		return;
+
+	free_slot_t* slot = pointer;
+	slot->next = arena->free_slots[class];
+	arena->free_slots[class] = slot;
+}
+
+oolong_error_t oolong_arena_track(oolong_arena_t* arena, void* object, oolong_arena_release_t release)
+{
+	if (arena == NULL || object == NULL || release == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (arena->tracked_length == arena->tracked_capacity)
+	{
+		size_t capacity = arena->tracked_capacity == 0 ? 64 : arena->tracked_capacity * 2;
+		tracked_t* new_tracked = oolong_memory_reallocate(arena->tracked, capacity, sizeof *arena->tracked);
+
+		if (new_tracked == NULL)
+			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+		arena->tracked = new_tracked;
+		arena->tracked_capacity = capacity;
+	}
+
+	arena->tracked[arena->tracked_length++] = (tracked_t){ .object = object, .release = release };
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_arena_untrack(oolong_arena_t* arena, void* object)
+{
+	if (arena == NULL || object == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	for (size_t index = arena->tracked_length; index > 0; index--)
+	{
+		if (arena->tracked[index - 1].object == object)
+		{
+			arena->tracked[index - 1].object = NULL;
+
+			/* Trailing untracked entries can be reused right away. */
+			while (arena->tracked_length > 0 && arena->tracked[arena->tracked_length - 1].object == NULL)
+				arena->tracked_length--;
+
+			return OOLONG_ERROR_NONE;
+		}
+	}
+
+	return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+}
+
+size_t oolong_arena_get_size(oolong_arena_t* arena)
+{
+	if (arena == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	return arena->heap_size;
+}
@@ -0,0 +1,80 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_ARENA_H
+#define OOLONG_ARENA_H
+
+#include <stddef.h>
+#include "error.h"
+
+/* Size of the blocks an arena takes from the heap when given a block size of 0. */
+#define OOLONG_ARENA_DEFAULT_BLOCK_SIZE 65536
+
+/* 
+ * Allocations are rounded up to a power of two size class from the smallest
+ * to the largest here, freed memory is kept per class for reuse. Anything
+ * larger is given its own heap allocation, still freed with the arena.
+ */
+#define OOLONG_ARENA_SMALLEST_CLASS 32
+#define OOLONG_ARENA_LARGEST_CLASS 4096
+
+typedef struct oolong_arena_s oolong_arena_t;
+typedef void (*oolong_arena_release_t)(void* object);
+
+/*
+ * Creates an arena that hands out memory from blocks of the given size, taken
+ * from the heap as needed. Labels, buttons, and text boxes created in an arena
+ * with their *_create_in() functions keep themselves and their rendered strings
+ * in it, so building a screen of thousands of elements costs a few heap
+ * allocations and destroying the arena frees all of it at once.
+ *
+ * An arena is not thread safe, so oolong_element_render_strings() renders any
+ * array holding elements created in one on a single thread.
+ */
+oolong_arena_t* oolong_arena_create(size_t block_size);
+
+/*
+ * Releases everything still tracked by the arena, as if each element created in
+ * it were destroyed, and frees all of the arena's memory. Nothing allocated from
+ * the arena may be used afterwards.
+ */
+oolong_error_t oolong_arena_destroy(oolong_arena_t* arena);
+
+/*
+ * Allocates memory from the arena, aligned for any type. Returns NULL on
+ * failure.
+ */
+void* oolong_arena_allocate(oolong_arena_t* arena, size_t size);
+
+/*
+ * Resizes memory allocated from the arena, which may be NULL with an old size
+ * of 0, moving it to a different size class if needed.
+ */
+void* oolong_arena_reallocate(oolong_arena_t* arena, void* pointer, size_t old_size, size_t size);
+
+/*
+ * Gives memory back to the arena for reuse by allocations of its size class.
+ */
+void oolong_arena_free(oolong_arena_t* arena, void* pointer, size_t size);
+
+/*
+ * Tracks an object living in the arena so that the given function releases
+ * whatever it holds outside of the arena, such as style sets, when the arena is
+ * destroyed. Used by the *_create_in() functions.
+ */
+oolong_error_t oolong_arena_track(oolong_arena_t* arena, void* object, oolong_arena_release_t release);
+
+/*
+ * Stops tracking an object, for when it is destroyed on its own before the
+ * arena. Recently tracked objects are found fastest.
+ */
+oolong_error_t oolong_arena_untrack(oolong_arena_t* arena, void* object);
+
+/*
+ * Gets the number of bytes the arena has taken from the heap.
+ */
+size_t oolong_arena_get_size(oolong_arena_t* arena);
+
+#endif // OOLONG_ARENA_H
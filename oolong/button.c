@@ -3,14 +3,43 @@
  * See LICENSE file in repository root for complete license text.
  */
 
+#include "memory.h"
 #include "button.h"
 
 struct oolong_button_s
 {
 	oolong_element_t element_data;
+	wchar_t inline_string[OOLONG_ELEMENT_INLINE_STRING_LENGTH + 1];
 };
 
+/*
+ * Frees what the button holds outside of its own memory and arena.
+ */
+static void release(void* object)
+{
+	oolong_button_t* button = object;
+
+	if (button->element_data.style_normal != NULL)
+		oolong_style_set_destroy(button->element_data.style_normal);
+
+	oolong_style_set_t* style_selected = oolong_element_get_state_style(&button->element_data, OOLONG_ELEMENT_STATE_SELECTED);
+	oolong_style_set_t* style_disabled = oolong_element_get_state_style(&button->element_data, OOLONG_ELEMENT_STATE_DISABLED);
+
+	if (style_selected != NULL)
+		oolong_style_set_destroy(style_selected);
+
+	if (style_disabled != NULL)
+		oolong_style_set_destroy(style_disabled);
+
+	oolong_element_destroy_caches(&button->element_data);
+}
+
 oolong_button_t* oolong_button_create(oolong_button_options_t* options)
+{
+	return oolong_button_create_in(NULL, options);
+}
+
+oolong_button_t* oolong_button_create_in(oolong_arena_t* arena, oolong_button_options_t* options)
 {
 	if (options == NULL)
 	{
@@ -18,7 +47,7 @@ oolong_button_t* oolong_button_create(oolong_button_options_t* options)
 		return NULL;
 	}
 
-	oolong_button_t* button = malloc(sizeof(oolong_button_t));
+	oolong_button_t* button = arena == NULL ? oolong_memory_allocate(sizeof *button) : oolong_arena_allocate(arena, sizeof *button);
 
 	if (button == NULL)
 	{
@@ -33,11 +62,25 @@ oolong_button_t* oolong_button_create(oolong_button_options_t* options)
 	button->element_data.padding 			= options->padding;
 	button->element_data.width 				= options->width;
 	button->element_data.style_normal 		= options->style_normal;
-	button->element_data.style_selected 	= options->style_selected;
-	button->element_data.style_active		= NULL;
-	button->element_data.style_disabled 	= options->style_disabled;
 	button->element_data.content 			= options->content;
 	button->element_data.string 			= NULL;
+	button->element_data.inline_string		= button->inline_string;
+	button->element_data.string_capacity	= 0;
+	button->element_data.measured_content	= NULL;
+	button->element_data.sized_content		= NULL;
+	button->element_data.content_length		= 0;
+	button->element_data.string_length		= 0;
+	button->element_data.cold				= NULL;
+	button->element_data.arena				= arena;
+
+	if (oolong_element_set_style(&button->element_data, OOLONG_ELEMENT_STATE_SELECTED, options->style_selected) != OOLONG_ERROR_NONE
+		|| oolong_element_set_style(&button->element_data, OOLONG_ELEMENT_STATE_DISABLED, options->style_disabled) != OOLONG_ERROR_NONE
+		|| (arena != NULL && oolong_arena_track(arena, button, release) != OOLONG_ERROR_NONE))
+	{
+		oolong_element_destroy_caches(&button->element_data);
+		oolong_element_free(&button->element_data, button, sizeof *button);
+		return NULL;
+	}
 
 	return button;
 }
@@ -47,11 +90,19 @@ oolong_error_t oolong_button_destroy(oolong_button_t* button)
 	if (button == NULL)
 		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
 
-	oolong_style_set_destroy(button->element_data.style_normal);
-	oolong_style_set_destroy(button->element_data.style_selected);
-	oolong_style_set_destroy(button->element_data.style_disabled);
-	free(button->element_data.string);
-	free(button);
+	oolong_arena_t* arena = button->element_data.arena;
+
+	release(button);
+	oolong_element_free_string(&button->element_data);
+
+	if (arena == NULL)
+	{
+		oolong_memory_free(button);
+		return OOLONG_ERROR_NONE;
+	}
+
+	oolong_arena_untrack(arena, button);
+	oolong_arena_free(arena, button, sizeof *button);
 	return OOLONG_ERROR_NONE;
 }
 
@@ -34,6 +34,13 @@ struct oolong_button_options_s
  */
 oolong_button_t* oolong_button_create(oolong_button_options_t* options);
 
+/*
+ * Creates a button as oolong_button_create() does but keeps it and its rendered string
+ * in the given arena, or on the heap if the arena is NULL. The button may still be
+ * destroyed on its own, otherwise destroying the arena destroys it.
+ */
+oolong_button_t* oolong_button_create_in(oolong_arena_t* arena, oolong_button_options_t* options);
+
 /*
  * Frees all memory used by the button. This will not free the content member
  * given with the options struct while creating the button.
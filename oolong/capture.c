@@ -0,0 +1,233 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <time.h>
+#include <limits.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "memory.h"
+#include "capture.h"
+
+/*
+ * Captured output is queued in a byte buffer as a header followed by the
+ * output's wide characters. The writer thread swaps the queue for an empty
+ * buffer and encodes it without holding the lock, so presenting a frame only
+ * ever waits for a swap.
+ */
+struct queued_output_s
+{
+	double time;	/* Seconds since the capture started. */
+	size_t length;	/* Wide characters following the header. */
+};
+
+struct queue_s
+{
+	char* bytes;
+	size_t length;
+	size_t capacity;
+};
+
+typedef struct queued_output_s queued_output_t;
+typedef struct queue_s queue_t;
+
+static pthread_mutex_t queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_filled = PTHREAD_COND_INITIALIZER;
+static pthread_t writer_thread;
+
+static atomic_bool active = false;
+static bool stopping = false;
+static FILE* capture_file = NULL;
+static struct timespec start_time;
+static queue_t queue = { 0 };
+static queue_t draining = { 0 };
+
+static double seconds_since_start(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start_time.tv_sec) + (now.tv_nsec - start_time.tv_nsec) / 1e9;
+}
+
+static bool queue_push(queue_t* target, queued_output_t* header, const wchar_t* output)
+{
+	size_t length = sizeof *header + header->length * sizeof *output;
+
+	if (target->length + length > target->capacity)
+	{
+		size_t capacity = target->capacity == 0 ? 4096 : target->capacity;
+
+		while (capacity < target->length + length)
+			capacity *= 2;
+
+		char* new_bytes = oolong_memory_reallocate(target->bytes, capacity, 1);
+
+		if (new_bytes == NULL)
+			return false;
+
+		target->bytes = new_bytes;
+		target->capacity = capacity;
+	}
+
+	memcpy(&target->bytes[target->length], header, sizeof *header);
+	memcpy(&target->bytes[target->length + sizeof *header], output, header->length * sizeof *output);
+	target->length += length;
+	return true;
+}
+
+/*
+ * Writes output as a JSON string, escaping quotes, backslashes and control
+ * characters and encoding everything else as UTF-8. A newline is written with
+ * a carriage return before it, as a terminal's output post processing would
+ * send it, since players replay the output raw.
+ */
+static void write_json_string(const wchar_t* output, size_t length)
+{
+	char encoded[MB_LEN_MAX];
+	mbstate_t state = { 0 };
+
+	fputc('"', capture_file);
+
+	for (size_t index = 0; index < length; index++)
+	{
+		wchar_t character = output[index];
+
+		if (character == L'"' || character == L'\\')
+		{
+			fputc('\\', capture_file);
+			fputc(character, capture_file);
+		}
+		else if (character == L'\n')
+		{
+			fputs(index > 0 && output[index - 1] == L'\r' ? "\\n" : "\\r\\n", capture_file);
+		}
+		else if (character < 0x20 || character == 0x7F)
+		{
+			fprintf(capture_file, "\\u%04x", (unsigned int)character);
+		}
+		else
+		{
+			size_t encoded_length = wcrtomb(encoded, character, &state);
+
+			if (encoded_length != (size_t)-1)
+				fwrite(encoded, 1, encoded_length, capture_file);
+		}
+	}
+
+	fputc('"', capture_file);
+}
+
+static void* writer_main(void* unused)
+{
+	(void)unused;
+	pthread_mutex_lock(&queue_mutex);
+
+	for (;;)
+	{
+		while (queue.length == 0 && !stopping)
+			pthread_cond_wait(&queue_filled, &queue_mutex);
+
+		if (queue.length == 0)
+			break;
+
+		queue_t swapped = queue;
+		queue = draining;
+		queue.length = 0;
+		draining = swapped;
+
+		pthread_mutex_unlock(&queue_mutex);
+
+		for (size_t offset = 0; offset < draining.length;)
+		{
+			queued_output_t header;
+			memcpy(&header, &draining.bytes[offset], sizeof header);
+			offset += sizeof header;
+
+			fprintf(capture_file, "[%.6f, \"o\", ", header.time);
+			write_json_string((const wchar_t*)&draining.bytes[offset], header.length);
+			fputs("]\n", capture_file);
+			offset += header.length * sizeof(wchar_t);
+		}
+
+		pthread_mutex_lock(&queue_mutex);
+	}
+
+	pthread_mutex_unlock(&queue_mutex);
+	return NULL;
+}
+
+oolong_error_t oolong_capture_start(FILE* file, unsigned int columns, unsigned int rows)
+{
+	if (file == NULL || columns < 1 || rows < 1 || atomic_load(&active))
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	fprintf(file, "{\"version\": 2, \"width\": %u, \"height\": %u, \"timestamp\": %lld}\n", columns, rows, (long long)time(NULL));
+
+	if (ferror(file))
+		return oolong_error_record(OOLONG_ERROR_FAILED_IO_WRITE);
+
+	capture_file = file;
+	stopping = false;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+	if (pthread_create(&writer_thread, NULL, writer_main, NULL) != 0)
+		return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+	atomic_store(&active, true);
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_capture_stop(void)
+{
+	if (!atomic_load(&active))
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	atomic_store(&active, false);
+
+	pthread_mutex_lock(&queue_mutex);
+	stopping = true;
+	pthread_cond_signal(&queue_filled);
+	pthread_mutex_unlock(&queue_mutex);
+	pthread_join(writer_thread, NULL);
+
+	oolong_memory_free(queue.bytes);
+	oolong_memory_free(draining.bytes);
+	queue = (queue_t){ 0 };
+	draining = (queue_t){ 0 };
+
+	bool failed = fflush(capture_file) != 0 || ferror(capture_file);
+	capture_file = NULL;
+
+	if (failed)
+		return oolong_error_record(OOLONG_ERROR_FAILED_IO_WRITE);
+
+	return OOLONG_ERROR_NONE;
+}
+
+bool oolong_capture_is_active(void)
+{
+	return atomic_load_explicit(&active, memory_order_relaxed);
+}
+
+oolong_error_t oolong_capture_output(const wchar_t* output, size_t length)
+{
+	if (output == NULL && length > 0)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (!oolong_capture_is_active())
+		return OOLONG_ERROR_NONE;
+
+	queued_output_t header = { .time = seconds_since_start(), .length = length };
+
+	pthread_mutex_lock(&queue_mutex);
+	bool queued = queue_push(&queue, &header, output);
+	pthread_cond_signal(&queue_filled);
+	pthread_mutex_unlock(&queue_mutex);
+
+	if (!queued)
+		return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+	return OOLONG_ERROR_NONE;
+}
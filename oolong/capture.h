@@ -0,0 +1,41 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_CAPTURE_H
+#define OOLONG_CAPTURE_H
+
+#include <stdio.h>
+#include <wchar.h>
+#include <stdbool.h>
+#include "error.h"
+
+/*
+ * Starts capturing the output of every presented frame to the given file as an
+ * asciicast v2 recording of a terminal the given size, which can be played with
+ * standard asciicast players or read line by line as JSON. Frames are copied
+ * aside when presented and encoded and written by a background thread, so the
+ * capture costs little more than a copy on the thread printing. The file is not
+ * closed by oolong.
+ */
+oolong_error_t oolong_capture_start(FILE* file, unsigned int columns, unsigned int rows);
+
+/*
+ * Stops capturing, waiting for every captured frame to be written and then
+ * flushing the file.
+ */
+oolong_error_t oolong_capture_stop(void);
+
+/*
+ * Checks whether output is being captured.
+ */
+bool oolong_capture_is_active(void);
+
+/*
+ * Queues output to be captured as a single event, called by
+ * oolong_frame_present() for every frame while capturing.
+ */
+oolong_error_t oolong_capture_output(const wchar_t* output, size_t length);
+
+#endif // OOLONG_CAPTURE_H
@@ -5,8 +5,67 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "worker_pool.h"
+#include "memory.h"
+#include "width.h"
+#include "frame.h"
 #include "element.h"
 
+/*
+ * Parts of an element that most elements never use, kept out of the element so
+ * that it stays small.
+ */
+struct oolong_element_cold_s
+{
+	oolong_style_set_t* style_selected;				/* Style while state is selected. */
+	oolong_style_set_t* style_active;				/* Style while state is active. */
+	oolong_style_set_t* style_disabled;				/* Style while state is disabled. */
+	oolong_graphemes_t graphemes;					/* Cached grapheme cluster boundaries of the content. */
+	oolong_wrap_t wrap;								/* Cached line breaks of the content. */
+};
+
+typedef struct render_job_s render_job_t;
+
+struct render_job_s
+{
+	oolong_element_t** elements;
+	size_t elements_length;
+	atomic_size_t next_index;		/* Index of the next unclaimed chunk of elements. */
+	pthread_mutex_t error_mutex;	/* Guards 'error'. */
+	oolong_error_record_t error;	/* First error encountered by any thread. */
+};
+
+static void render_job_run(void* argument)
+{
+	render_job_t* job = argument;
+
+	for (;;)
+	{
+		size_t start = atomic_fetch_add_explicit(&job->next_index, OOLONG_ELEMENT_RENDER_CHUNK, memory_order_relaxed);
+
+		if (start >= job->elements_length)
+			return;
+
+		size_t end = start + OOLONG_ELEMENT_RENDER_CHUNK;
+		end = end > job->elements_length ? job->elements_length : end;
+
+		for (size_t index = start; index < end; index++)
+		{
+			if (oolong_element_render_string(job->elements[index]) == OOLONG_ERROR_NONE)
+				continue;
+
+			pthread_mutex_lock(&job->error_mutex);
+
+			if (job->error.error == OOLONG_ERROR_NONE)
+				job->error = oolong_error_get_last();
+
+			pthread_mutex_unlock(&job->error_mutex);
+		}
+	}
+}
+
 enum_t oolong_element_get_selected_identifier(oolong_element_t** elements, enum_t on_error)
 {
 	ssize_t selected_index = oolong_element_get_selected_index(elements);
@@ -35,77 +94,65 @@ ssize_t oolong_element_get_selected_index(oolong_element_t** elements)
 	return -1;
 }
 
-oolong_error_t oolong_element_render_string(oolong_element_t* element)
+/*
+ * Everything worked out about an element before its output is written.
+ */
+typedef struct render_layout_s
 {
-	size_t element_string_length = 0;
-	wchar_t* current_style = NULL;
-	wchar_t* current_stye_end = OOLONG_STYLE_CLEAR_STRING;
+	wchar_t* style;
+	wchar_t* style_end;
+	size_t content_length;
+	size_t length;
+	unsigned int preceding_spaces;
+	unsigned int following_spaces;
+} render_layout_t;
 
-	switch (element->state)
-	{
-		case (OOLONG_ELEMENT_STATE_NORMAL):		current_style = element->style_normal;		break;
-		case (OOLONG_ELEMENT_STATE_SELECTED):	current_style = element->style_selected;	break;
-		case (OOLONG_ELEMENT_STATE_ACTIVE):		current_style = element->style_active;		break;
-		case (OOLONG_ELEMENT_STATE_DISABLED):	current_style = element->style_disabled;	break;
-	}
+/*
+ * Measures the element's output, recording its width and style sizes on the
+ * element as well.
+ */
+static oolong_error_t lay_out(oolong_element_t* element, render_layout_t* layout)
+{
+	layout->style = oolong_element_get_style(element);
+	layout->style_end = OOLONG_STYLE_CLEAR_STRING;
 
-	if (current_style == NULL)
+	if (layout->style == NULL)
 	{
-		current_style = L"";
-		current_stye_end = L"";
+		layout->style = L"";
+		layout->style_end = L"";
 
 		element->preceding_style_size = 0;
 		element->following_style_size = 0;
 	}
 	else
 	{
-		element->preceding_style_size = wcslen(current_style);
-		element->following_style_size = wcslen(current_stye_end);
+		element->preceding_style_size = wcslen(layout->style);
+		element->following_style_size = wcslen(layout->style_end);
 	}
 
-	element_string_length += element->padding * 2;
-	element_string_length += wcslen(element->content);
-	element_string_length = element_string_length < element->width ? element->width : element_string_length;
+	/* 
+	 * Alignment works in terminal columns, which for content with wide or zero
+	 * width characters is not the same as its number of characters.
+	 */
 
-	element_string_length += element->preceding_style_size;
-	element_string_length += element->following_style_size;
-	
-	if (element->string == NULL)
-	{
-		wchar_t* new_string = calloc(element_string_length + 1, sizeof *element->string);
+	size_t content_width = oolong_element_get_content_width(element);
+	size_t string_width = content_width + element->padding * 2;
+	string_width = string_width < element->width ? element->width : string_width;
 
-		if (new_string == NULL)
-			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
-		
-		element->string = new_string;
-		element->string[element_string_length] = L'\0';
-	}
-	else if (element_string_length != wcslen(element->string))
-	{
-		wchar_t* new_string = reallocarray(element->string, element_string_length + 1, sizeof *element->string);
-
-		if (new_string == NULL)
-			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
-		
-		element->string = new_string;
-		element->string[element_string_length] = L'\0';
-	}
-
-	size_t current_index = 0;
+	element->string_width = string_width;
+	layout->content_length = oolong_element_get_content_length(element);
+	layout->length = string_width - content_width + layout->content_length;
+	layout->length += element->preceding_style_size;
+	layout->length += element->following_style_size;
 
-	wcscpy(element->string, current_style);
-	current_index += element->preceding_style_size;
-
-	unsigned int total_spaces = element_string_length - wcslen(current_style) - wcslen(OOLONG_STYLE_CLEAR_STRING) - wcslen(element->content) - (2 * element->padding);
-	unsigned int preceding_spaces;
-	unsigned int following_spaces;
+	unsigned int total_spaces = string_width - content_width - (2 * element->padding);
 	
 	switch (element->alignment)
 	{
 		case (OOLONG_ALIGN_LEFT):
 		{
-			preceding_spaces = element->padding;
-			following_spaces = total_spaces + element->padding;
+			layout->preceding_spaces = element->padding;
+			layout->following_spaces = total_spaces + element->padding;
 			break;
 		}
 
@@ -113,15 +160,15 @@ oolong_error_t oolong_element_render_string(oolong_element_t* element)
 		{
 			unsigned int remainder = total_spaces % 2;
 			unsigned int half_spaces = (total_spaces - remainder) / 2;
-			preceding_spaces = half_spaces + element->padding;
-			following_spaces = half_spaces + element->padding + remainder;
+			layout->preceding_spaces = half_spaces + element->padding;
+			layout->following_spaces = half_spaces + element->padding + remainder;
 			break;
 		}
 
 		case (OOLONG_ALIGN_RIGHT):
 		{
-			preceding_spaces = total_spaces + element->padding;
-			following_spaces = element->padding;
+			layout->preceding_spaces = total_spaces + element->padding;
+			layout->following_spaces = element->padding;
 			break;
 		}
 
@@ -136,16 +183,423 @@ oolong_error_t oolong_element_render_string(oolong_element_t* element)
 		}
 	}
 
-	wmemset(&element->string[current_index], L' ', preceding_spaces);
-	current_index += preceding_spaces;
+	return OOLONG_ERROR_NONE;
+}
+
+/*
+ * Writes the element's output, exactly 'layout->length' characters without a
+ * terminator, to the given destination.
+ */
+static void write_layout(oolong_element_t* element, const render_layout_t* layout, wchar_t* destination)
+{
+	size_t current_index = 0;
+
+	wmemcpy(destination, layout->style, element->preceding_style_size);
+	current_index += element->preceding_style_size;
+
+	wmemset(&destination[current_index], L' ', layout->preceding_spaces);
+	current_index += layout->preceding_spaces;
+
+	wmemcpy(&destination[current_index], element->content, layout->content_length);
+	current_index += layout->content_length;
+
+	wmemset(&destination[current_index], L' ', layout->following_spaces);
+	current_index += layout->following_spaces;
+
+	wmemcpy(&destination[current_index], layout->style_end, element->following_style_size);
+}
+
+/*
+ * Gets the element's cold fields, taking memory for them the first time.
+ * Returns NULL on error.
+ */
+static oolong_element_cold_t* get_cold(oolong_element_t* element)
+{
+	if (element->cold != NULL)
+		return element->cold;
+
+	oolong_element_cold_t* cold = oolong_element_reallocate(element, NULL, 0, sizeof *cold);
+
+	if (cold == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+		return NULL;
+	}
+
+	*cold = (oolong_element_cold_t){ 0 };
+	element->cold = cold;
+	return cold;
+}
+
+/*
+ * Forgets cached grapheme and wrap data from the given content index onwards.
+ */
+static oolong_error_t invalidate_caches(oolong_element_t* element, size_t from)
+{
+	if (element->cold == NULL)
+		return OOLONG_ERROR_NONE;
+
+	oolong_wrap_invalidate_from(&element->cold->wrap, from);
+	return oolong_graphemes_invalidate_from(&element->cold->graphemes, from);
+}
+
+/*
+ * Checks the element's content against the copy of it in the rendered string,
+ * forgetting everything worked out from the content if it was rewritten in
+ * place since it was rendered. Comparing costs no more than reading the
+ * content once, which measuring or rendering it would do anyway.
+ */
+static void check_content(oolong_element_t* element)
+{
+	if (element->string == NULL || element->rendered_content != element->content)
+		return;
+
+	size_t length = oolong_element_get_content_length(element);
+
+	if (length == element->rendered_content_length && wmemcmp(element->content, &element->string[element->content_offset], length) == 0)
+		return;
+
+	element->measured_content = NULL;
+	element->dirty = true;
+	invalidate_caches(element, 0);
+}
+
+oolong_error_t oolong_element_render_string(oolong_element_t* element)
+{
+	oolong_style_set_t* style = oolong_element_get_style(element);
+	check_content(element);
+
+	/* Nothing the string is rendered from has changed, so the last string still stands. */
+	if (element->string != NULL && !element->dirty && element->rendered_content == element->content && element->rendered_style == style
+		&& element->rendered_alignment == element->alignment && element->rendered_padding == element->padding && element->rendered_width == element->width)
+	{
+		element->reused = true;
+		return OOLONG_ERROR_NONE;
+	}
+
+	render_layout_t layout;
+	oolong_error_t error = lay_out(element, &layout);
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+	
+	if (element->string == NULL && element->inline_string != NULL && layout.length <= OOLONG_ELEMENT_INLINE_STRING_LENGTH)
+	{
+		element->string = element->inline_string;
+		element->string_capacity = OOLONG_ELEMENT_INLINE_STRING_LENGTH;
+	}
+	else if (element->string == NULL || layout.length > element->string_capacity)
+	{
+		/* 
+		 * Most elements never change size, so only strings that have grown before
+		 * get room to spare. An outgrown inline string is left as it is.
+		 */
+
+		wchar_t* old_string = element->string == element->inline_string ? NULL : element->string;
+		size_t capacity = element->string == NULL ? layout.length : layout.length + layout.length / 2;
+		size_t old_size = old_string == NULL ? 0 : (element->string_capacity + 1) * sizeof *element->string;
+		wchar_t* new_string = oolong_element_reallocate(element, old_string, old_size, (capacity + 1) * sizeof *element->string);
+
+		if (new_string == NULL)
+			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+		
+		element->string = new_string;
+		element->string_capacity = capacity;
+	}
+
+	write_layout(element, &layout, element->string);
+	element->string[layout.length] = L'\0';
+	element->string_length = layout.length;
+	element->content_offset = element->preceding_style_size + layout.preceding_spaces;
+
+	element->rendered_style = style;
+	element->rendered_content = element->content;
+	element->rendered_content_length = layout.content_length;
+	element->rendered_alignment = element->alignment;
+	element->rendered_padding = element->padding;
+	element->rendered_width = element->width;
+	element->dirty = false;
+	element->reused = false;
+	return OOLONG_ERROR_NONE;
+}
+
+/*
+ * The layout oolong_element_measure() last worked out on this thread, with what
+ * it was worked out from, so that rendering the element into the frame straight
+ * after measuring it need not lay it out again.
+ */
+static _Thread_local struct
+{
+	oolong_element_t* element;
+	wchar_t* content;
+	oolong_element_state_t state;
+	oolong_alignment_t alignment;
+	unsigned int padding;
+	unsigned int width;
+	render_layout_t layout;
+} measured = { .element = NULL };
+
+oolong_error_t oolong_element_measure(oolong_element_t* element)
+{
+	if (element == NULL || element->content == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	oolong_error_t error = lay_out(element, &measured.layout);
+
+	measured.element = error == OOLONG_ERROR_NONE ? element : NULL;
+	measured.content = element->content;
+	measured.state = element->state;
+	measured.alignment = element->alignment;
+	measured.padding = element->padding;
+	measured.width = element->width;
+	return error;
+}
+
+/*
+ * Checks that the element was the last measured on this thread and has not
+ * changed since.
+ */
+static bool was_just_measured(oolong_element_t* element)
+{
+	return measured.element == element
+		&& measured.content == element->content
+		&& measured.state == element->state
+		&& measured.alignment == element->alignment
+		&& measured.padding == element->padding
+		&& measured.width == element->width;
+}
+
+oolong_error_t oolong_element_render_to_frame(oolong_element_t* element)
+{
+	if (element == NULL || element->content == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	render_layout_t layout;
+
+	if (was_just_measured(element))
+	{
+		layout = measured.layout;
+		measured.element = NULL;
+	}
+	else
+	{
+		oolong_error_t error = lay_out(element, &layout);
+
+		if (error != OOLONG_ERROR_NONE)
+			return error;
+	}
+
+	wchar_t* destination = oolong_frame_reserve(layout.length);
+
+	if (destination == NULL)
+		return oolong_error_get_last().error;
+
+	write_layout(element, &layout, destination);
+	return OOLONG_ERROR_NONE;
+}
+
+/*
+ * Gets the padding either side of an element's content when laid out in the
+ * given number of columns, cut down to leave the content at least one column.
+ */
+static unsigned int get_padding(oolong_element_t* element, unsigned int columns)
+{
+	if (columns > 2 * element->padding)
+		return element->padding;
+
+	return columns > 0 ? (columns - 1) / 2 : 0;
+}
+
+/*
+ * Gets the columns an element's content is wrapped to when laid out in the
+ * given number of columns.
+ */
+static unsigned int get_wrap_columns(oolong_element_t* element, unsigned int columns)
+{
+	return columns > 0 ? columns - 2 * get_padding(element, columns) : 1;
+}
+
+size_t oolong_element_get_height(oolong_element_t* element, unsigned int columns)
+{
+	if (element == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	/* Content that fits is one line whatever width the string was last rendered at. */
+	if (oolong_element_get_content_width(element) + 2 * element->padding <= columns)
+		return 1;
+
+	oolong_wrap_t* wrap = oolong_element_get_wrap(element, get_wrap_columns(element, columns));
+	return wrap == NULL || wrap->count == 0 ? 1 : wrap->count;
+}
+
+oolong_error_t oolong_element_compose_line(oolong_element_t* element, unsigned int columns, size_t line)
+{
+	if (element == NULL || (element->string == NULL && element->string_width <= columns))
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	wchar_t* destination;
+
+	if (element->string_width <= columns)
+	{
+		size_t string_length = line == 0 ? element->string_length : 0;
+		size_t fill = line == 0 ? columns - element->string_width : columns;
+
+		if ((destination = oolong_frame_reserve(string_length + fill)) == NULL)
+			return oolong_error_get_last().error;
+
+		wmemcpy(destination, element->string, string_length);
+		wmemset(&destination[string_length], L' ', fill);
+		return OOLONG_ERROR_NONE;
+	}
+
+	/* 
+	 * Every wrapped line is filled out to the full width so that a background
+	 * style still looks like a single block, and the style is cleared at the end
+	 * of each line so that it does not colour whatever follows.
+	 */
+
+	if (columns == 0)
+		return OOLONG_ERROR_NONE;
+
+	unsigned int padding = get_padding(element, columns);
+	unsigned int wrap_columns = get_wrap_columns(element, columns);
+	oolong_wrap_t* wrap = oolong_element_get_wrap(element, wrap_columns);
+
+	if (wrap == NULL)
+		return oolong_error_get_last().error;
+
+	oolong_wrap_line_t* wrap_line = oolong_wrap_get_line(wrap, line);
+
+	if (wrap_line == NULL)
+		return oolong_frame_fill(L' ', columns);
 
-	wcscpy(&element->string[current_index], element->content);
-	current_index += wcslen(element->content);
+	size_t style_size = element->preceding_style_size;
+	size_t style_end_size = element->following_style_size;
+	unsigned int fill = wrap_line->width < wrap_columns ? wrap_columns - wrap_line->width : 0;
 
-	wmemset(&element->string[current_index], L' ', following_spaces);
-	current_index += following_spaces;
+	if ((destination = oolong_frame_reserve(style_size + padding + wrap_line->length + fill + padding + style_end_size)) == NULL)
+		return oolong_error_get_last().error;
 
-	wcscpy(&element->string[current_index], current_stye_end);
+	destination = wmemcpy(destination, oolong_element_get_style(element), style_size) + style_size;
+	destination = wmemset(destination, L' ', padding) + padding;
+	destination = wmemcpy(destination, &element->content[wrap_line->start], wrap_line->length) + wrap_line->length;
+	destination = wmemset(destination, L' ', fill + padding) + fill + padding;
+	wmemcpy(destination, OOLONG_STYLE_CLEAR_STRING, style_end_size);
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_style_set_t* oolong_element_get_style(oolong_element_t* element)
+{
+	return oolong_element_get_state_style(element, element->state);
+}
+
+oolong_style_set_t* oolong_element_get_state_style(oolong_element_t* element, oolong_element_state_t state)
+{
+	if (state == OOLONG_ELEMENT_STATE_NORMAL)
+		return element->style_normal;
+
+	if (element->cold == NULL)
+		return NULL;
+
+	switch (state)
+	{
+		case (OOLONG_ELEMENT_STATE_SELECTED):	return element->cold->style_selected;
+		case (OOLONG_ELEMENT_STATE_ACTIVE):		return element->cold->style_active;
+		case (OOLONG_ELEMENT_STATE_DISABLED):	return element->cold->style_disabled;
+		default:								return NULL;
+	}
+}
+
+oolong_error_t oolong_element_set_style(oolong_element_t* element, oolong_element_state_t state, oolong_style_set_t* style)
+{
+	if (element == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (state == OOLONG_ELEMENT_STATE_NORMAL)
+	{
+		element->style_normal = style;
+		return OOLONG_ERROR_NONE;
+	}
+
+	if (style == NULL && element->cold == NULL)
+		return OOLONG_ERROR_NONE;
+
+	oolong_element_cold_t* cold = get_cold(element);
+
+	if (cold == NULL)
+		return OOLONG_ERROR_NOT_ENOUGH_MEMORY;
+
+	switch (state)
+	{
+		case (OOLONG_ELEMENT_STATE_SELECTED):	cold->style_selected = style;	break;
+		case (OOLONG_ELEMENT_STATE_ACTIVE):		cold->style_active = style;		break;
+		case (OOLONG_ELEMENT_STATE_DISABLED):	cold->style_disabled = style;	break;
+		default:								return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+	}
+
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_element_render_strings(oolong_element_t** elements, unsigned int threads)
+{
+	if (elements == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	size_t elements_length = 0;
+	bool in_arena = false;
+
+	/* Arenas are not thread safe, so strings growing in one must do so on one thread. */
+	for (; elements[elements_length] != NULL; elements_length++)
+		in_arena |= elements[elements_length]->arena != NULL;
+
+	if (threads < 2 || in_arena || elements_length < OOLONG_ELEMENT_PARALLEL_RENDER_THRESHOLD)
+	{
+		oolong_error_t error = OOLONG_ERROR_NONE;
+
+		for (size_t index = 0; index < elements_length; index++)
+		{
+			oolong_error_t element_error = oolong_element_render_string(elements[index]);
+			error = error == OOLONG_ERROR_NONE ? element_error : error;
+		}
+
+		return error;
+	}
+
+	size_t chunks = (elements_length + OOLONG_ELEMENT_RENDER_CHUNK - 1) / OOLONG_ELEMENT_RENDER_CHUNK;
+	threads = threads > chunks ? chunks : threads;
+
+	render_job_t job =
+	{
+		.elements = elements,
+		.elements_length = elements_length,
+		.error = { .error = OOLONG_ERROR_NONE }
+	};
+
+	atomic_init(&job.next_index, 0);
+	pthread_mutex_init(&job.error_mutex, NULL);
+	oolong_error_t error = oolong_worker_pool_run(threads, render_job_run, &job);
+	pthread_mutex_destroy(&job.error_mutex);
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+
+	/* 
+	 * The error was recorded on whichever thread found it, record it again here
+	 * so the caller can see it.
+	 */
+
+	return oolong_error_debug_record(job.error.error, job.error.file, job.error.function, job.error.line);
+}
+
+oolong_error_t oolong_element_mark_dirty(oolong_element_t* element)
+{
+	if (element == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	element->dirty = true;
 	return OOLONG_ERROR_NONE;
 }
 
@@ -160,6 +614,183 @@ wchar_t* oolong_element_get_string(oolong_element_t* element)
 	return element->string;
 }
 
+size_t oolong_element_get_string_length(oolong_element_t* element)
+{
+	if (element == NULL || element->string == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	return element->string_length;
+}
+
+oolong_error_t oolong_element_set_content(oolong_element_t* element, wchar_t* content)
+{
+	if (element == NULL || content == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	oolong_error_t error = oolong_element_set_content_slice(element, content, wcslen(content));
+
+	/* Terminated content is counted again whenever its length is needed, in case it is rewritten. */
+	element->sized_content = NULL;
+	return error;
+}
+
+oolong_error_t oolong_element_set_content_slice(oolong_element_t* element, wchar_t* content, size_t length)
+{
+	if (element == NULL || content == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	element->content = content;
+	element->sized_content = content;
+	element->content_length = length;
+	element->measured_content = NULL;
+	element->dirty = true;
+	return invalidate_caches(element, 0);
+}
+
+oolong_error_t oolong_element_invalidate_content(oolong_element_t* element, size_t from, size_t length)
+{
+	if (element == NULL || from > length)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	element->sized_content = element->content;
+	element->content_length = length;
+	element->measured_content = NULL;
+	element->dirty = true;
+	return invalidate_caches(element, from);
+}
+
+oolong_graphemes_t* oolong_element_get_graphemes(oolong_element_t* element)
+{
+	if (element == NULL || element->content == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return NULL;
+	}
+
+	oolong_element_cold_t* cold = get_cold(element);
+
+	if (cold == NULL || oolong_graphemes_update(&cold->graphemes, element->content, oolong_element_get_content_length(element)) != OOLONG_ERROR_NONE)
+		return NULL;
+
+	return &cold->graphemes;
+}
+
+oolong_wrap_t* oolong_element_get_wrap(oolong_element_t* element, unsigned int columns)
+{
+	oolong_graphemes_t* graphemes = oolong_element_get_graphemes(element);
+
+	if (graphemes == NULL)
+		return NULL;
+
+	if (oolong_wrap_update(&element->cold->wrap, graphemes, columns) != OOLONG_ERROR_NONE)
+		return NULL;
+
+	return &element->cold->wrap;
+}
+
+oolong_error_t oolong_element_destroy_caches(oolong_element_t* element)
+{
+	if (element == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	oolong_element_cold_t* cold = element->cold;
+
+	if (cold == NULL)
+		return OOLONG_ERROR_NONE;
+
+	oolong_wrap_destroy(&cold->wrap);
+	oolong_graphemes_destroy(&cold->graphemes);
+	oolong_element_free(element, cold, sizeof *cold);
+	element->cold = NULL;
+	return OOLONG_ERROR_NONE;
+}
+
+void* oolong_element_reallocate(oolong_element_t* element, void* pointer, size_t old_size, size_t size)
+{
+	if (element == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return NULL;
+	}
+
+	if (element->arena != NULL)
+		return oolong_arena_reallocate(element->arena, pointer, old_size, size);
+
+	return oolong_memory_reallocate(pointer, size, 1);
+}
+
+void oolong_element_free(oolong_element_t* element, void* pointer, size_t size)
+{
+	if (element == NULL)
+		return;
+
+	if (element->arena != NULL)
+		oolong_arena_free(element->arena, pointer, size);
+	else
+		oolong_memory_free(pointer);
+}
+
+oolong_error_t oolong_element_free_string(oolong_element_t* element)
+{
+	if (element == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (element->string != element->inline_string)
+		oolong_element_free(element, element->string, (element->string_capacity + 1) * sizeof *element->string);
+
+	element->string = NULL;
+	element->string_capacity = 0;
+	return OOLONG_ERROR_NONE;
+}
+
+size_t oolong_element_get_content_width(oolong_element_t* element)
+{
+	if (element == NULL || element->content == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	check_content(element);
+
+	if (element->measured_content != element->content)
+	{
+		element->content_width = oolong_width_of_string(element->content, oolong_element_get_content_length(element));
+		element->measured_content = element->content;
+	}
+
+	return element->content_width;
+}
+
+size_t oolong_element_get_content_length(oolong_element_t* element)
+{
+	if (element == NULL || element->content == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	/* Only a length given with the content is kept, terminated content may be rewritten in place. */
+	if (element->sized_content != element->content)
+		element->content_length = wcslen(element->content);
+
+	return element->content_length;
+}
+
+size_t oolong_element_get_string_width(oolong_element_t* element)
+{
+	if (element == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	return element->string_width;
+}
+
 oolong_error_t oolong_element_select_next(oolong_element_t** elements)
 {
 	if (elements == NULL)
@@ -226,7 +857,7 @@ oolong_error_t oolong_element_select_previous(oolong_element_t** elements)
 
 size_t oolong_element_get_preceding_style_size(oolong_element_t* element)
 {
-	if (element == NULL || element->string == NULL)
+	if (element == NULL)
 	{
 		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
 		return 0;
@@ -238,7 +869,7 @@ size_t oolong_element_get_preceding_style_size(oolong_element_t* element)
 size_t oolong_element_get_following_style_size(oolong_element_t* element)
 {
 	
-	if (element == NULL || element->string == NULL)
+	if (element == NULL)
 	{
 		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
 		return 0;
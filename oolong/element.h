@@ -7,7 +7,24 @@
 #define OOLONG_ELEMENT_H
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include "styling.h"
+#include "grapheme.h"
+#include "wrap.h"
+#include "arena.h"
+
+/* Fewest elements for which rendering is split across threads. */
+#define OOLONG_ELEMENT_PARALLEL_RENDER_THRESHOLD 512
+
+/* Number of elements a render thread claims at a time. */
+#define OOLONG_ELEMENT_RENDER_CHUNK 64
+
+/* 
+ * Characters, not counting the terminator, that fit in the inline string of
+ * labels, buttons, and text boxes. Enough for about 24 characters of content
+ * with a style and the style clearing sequence.
+ */
+#define OOLONG_ELEMENT_INLINE_STRING_LENGTH 36
 
 #ifndef __GNUC__
 #warning "OOLONG: not compiling with GCC, element.h utilises GCC compiler extensions."
@@ -52,6 +69,7 @@ typedef int enum_t;
 typedef enum oolong_element_state_e oolong_element_state_t;
 typedef enum oolong_alignment_e oolong_alignment_t;
 typedef struct oolong_element_s oolong_element_t;
+typedef struct oolong_element_cold_s oolong_element_cold_t;
 
 /*
  * By making an instance of an element the first member of a struct you can
@@ -63,20 +81,46 @@ typedef struct oolong_element_s oolong_element_t;
 
 struct oolong_element_s
 {
-	enum_t identifier;							/* The enum value (or int) by which the element will be identified. */
-	oolong_element_state_t supported_states;	/* The supported states of the element. */
-	oolong_element_state_t state;				/* Current state of the element. */
-	oolong_alignment_t alignment;				/* Alignment of content within the element. */
-	unsigned int padding;						/* Padding of content within the element. */
-	unsigned int width;							/* Minimum width of the element, it may extend further. */
-	oolong_style_set_t* style_normal;			/* Style while state is normal. */
-	oolong_style_set_t* style_selected;			/* Style while state is selected. */
-	oolong_style_set_t* style_active;			/* Style while state is active. */
-	oolong_style_set_t* style_disabled;			/* Style while state is disabled. */
-	wchar_t* content;							/* Pointer to the element's content. */
-	wchar_t* string;							/* Output of rendering the element. */
-	size_t preceding_style_size;				/* Number of style characters at the beginning of the rendered string. */
-	size_t following_style_size;				/* Number of style characters at the end of the rendered string. */
+	/*
+	 * Fields read for every element by selection and layout come first and are
+	 * packed together so that scanning a long list of elements touches a single
+	 * cache line of each.
+	 */
+
+	oolong_element_state_t state : 4;				/* Current state of the element. */
+	oolong_element_state_t supported_states : 4;	/* The supported states of the element. */
+	oolong_alignment_t alignment : 2;				/* Alignment of content within the element. */
+	oolong_alignment_t rendered_alignment : 2;		/* Alignment the rendered string was rendered with. */
+	bool dirty : 1;									/* Set when the string must be rendered again even if nothing else changed. */
+	bool reused : 1;								/* Set when the last render kept the string as it was. */
+	enum_t identifier;								/* The enum value (or int) by which the element will be identified. */
+	unsigned int padding;							/* Padding of content within the element. */
+	unsigned int width;								/* Minimum width of the element, it may extend further. */
+	unsigned int rendered_padding;					/* Padding the rendered string was rendered with. */
+	unsigned int rendered_width;					/* Width the rendered string was rendered with. */
+
+	/* Fields used while rendering and printing. */
+
+	wchar_t* content;								/* Pointer to the element's content. */
+	wchar_t* sized_content;							/* Content that 'content_length' was given with, NULL if the content is terminated. */
+	size_t content_length;							/* Number of characters of content, which need not be terminated. */
+	wchar_t* measured_content;						/* Content that 'content_width' was measured from, NULL if not yet measured. */
+	size_t content_width;							/* Number of columns the content occupies on the terminal. */
+	wchar_t* string;								/* Output of rendering the element. */
+	size_t string_length;							/* Number of characters in 'string', not counting its terminator. */
+	size_t string_capacity;							/* Characters 'string' has room for, not counting its terminator. */
+	size_t string_width;							/* Number of columns the rendered string occupies on the terminal. */
+	size_t content_offset;							/* Index at which the content begins in the rendered string. */
+	unsigned int preceding_style_size;				/* Number of style characters at the beginning of the rendered string. */
+	unsigned int following_style_size;				/* Number of style characters at the end of the rendered string. */
+	wchar_t* inline_string;							/* Room for OOLONG_ELEMENT_INLINE_STRING_LENGTH characters in the containing struct, NULL if none. */
+	wchar_t* rendered_content;						/* Content the rendered string was rendered from. */
+	size_t rendered_content_length;					/* Characters of content the rendered string was rendered from. */
+	oolong_style_set_t* rendered_style;				/* Style set the rendered string was rendered with. */
+
+	oolong_style_set_t* style_normal;				/* Style while state is normal. */
+	struct oolong_element_cold_s* cold;				/* Styles for the other states and cached grapheme and wrap data, NULL until first needed. */
+	oolong_arena_t* arena;							/* Arena the element and its strings live in, NULL if they are on the heap. */
 };
 
 /*
@@ -96,19 +140,194 @@ ssize_t oolong_element_get_selected_index(oolong_element_t** elements);
 
 /*
  * Renders the element and makes it's member 'string' point to the result. This
- * function will allocate memory if 'string' is NULL and reallocate memory if
- * the string's current length is to short to hold the result, this is done
- * regardless of the actual size of the memory block. This function will not
- * reallocate to less that the previous size unless the string is terminated
- * before the end of the memory block.
+ * function will allocate memory if 'string' is NULL and reallocate memory only
+ * if the result does not fit in 'string_capacity', growing by half again so
+ * that an element whose width keeps changing settles on a size. The string is
+ * never shrunk, so rendering an element again allocates nothing unless it
+ * grows past anything it has rendered before. Elements with an inline string
+ * render into it, allocating nothing, until their string outgrows it.
+ *
+ * If the content, style, alignment, padding, and width are those the string
+ * was last rendered with and the element is not marked dirty the string is
+ * kept as is and 'reused' is set. Content rewritten in place is noticed by
+ * comparing it with the copy in the rendered string, style sets changed in
+ * place are not noticed unless set again or the element is marked dirty.
  */
 oolong_error_t oolong_element_render_string(oolong_element_t* element);
 
+/*
+ * Renders every element of the given array as oolong_element_render_string()
+ * would. Arrays of at least OOLONG_ELEMENT_PARALLEL_RENDER_THRESHOLD elements
+ * are split across up to 'threads' threads, each claiming chunks of elements
+ * until none remain, smaller arrays or a 'threads' of 0 or 1 render serially,
+ * as do arrays with any element created in an arena, since arenas are not
+ * thread safe. Since each element only ever writes its own string no two
+ * threads touch the same memory, the array itself must not be changed until
+ * this returns.
+ *
+ * Errors recorded while rendering on other threads are recorded again on the
+ * calling thread. The first error encountered is returned, though all elements
+ * will have been attempted.
+ *
+ * This function assumes that the array is terminated with a NULL pointer.
+ */
+oolong_error_t oolong_element_render_strings(oolong_element_t** elements, unsigned int threads);
+
+/*
+ * Works out the element's string width and style sizes as rendering it would,
+ * without rendering it, so that their getters can be used before rendering the
+ * element with oolong_element_render_to_frame(). What is worked out is kept for
+ * the next call to that function on the same thread, which uses it if given
+ * the same element with the same content, state, alignment, padding, and width.
+ */
+oolong_error_t oolong_element_measure(oolong_element_t* element);
+
+/*
+ * Renders the element as oolong_element_render_string() does but straight into
+ * the current frame's output (see oolong_frame_reserve()), leaving 'string' as
+ * it is. This saves copying the string into the frame and needs no memory of
+ * the element's own, at the cost of rendering the element every frame.
+ */
+oolong_error_t oolong_element_render_to_frame(oolong_element_t* element);
+
+/*
+ * Gets the number of lines the element takes up when laid out in the given
+ * number of columns, one unless its content and padding are wider and its
+ * content is word wrapped as oolong_element_compose_line() does. It does not
+ * depend on the element having been rendered.
+ */
+size_t oolong_element_get_height(oolong_element_t* element, unsigned int columns);
+
+/*
+ * Puts one line of the element, laid out in the given number of columns, into
+ * the current frame's output filled out with spaces to exactly that width. The
+ * rendered string is the first line if it fits, otherwise the content is word
+ * wrapped within the element's padding with every line styled, the padding
+ * being cut down where there are too few columns for it. Lines past the
+ * element's height are blank. The element must have been rendered, or only
+ * measured if its content is wrapped.
+ */
+oolong_error_t oolong_element_compose_line(oolong_element_t* element, unsigned int columns, size_t line);
+
+/*
+ * Gets the style set for the element's current state, NULL if it has none.
+ */
+oolong_style_set_t* oolong_element_get_style(oolong_element_t* element);
+
+/*
+ * Gets the style set the element uses while in the given state, NULL if it has
+ * none.
+ */
+oolong_style_set_t* oolong_element_get_state_style(oolong_element_t* element, oolong_element_state_t state);
+
+/*
+ * Sets the style set the element uses while in the given state. Styles for
+ * states other than normal are kept outside of the element, memory for them is
+ * only taken once one is set and is freed by oolong_element_destroy_caches().
+ */
+oolong_error_t oolong_element_set_style(oolong_element_t* element, oolong_element_state_t state, oolong_style_set_t* style);
+
+/*
+ * Makes the next render of the element render its string again, for when
+ * something it is rendered from, such as a style set, was changed in place.
+ */
+oolong_error_t oolong_element_mark_dirty(oolong_element_t* element);
+
 /*
  * Gets the element's rendered string.
  */
 wchar_t* oolong_element_get_string(oolong_element_t* element);
 
+/*
+ * Gets the number of characters in the element's rendered string, not counting
+ * its terminator.
+ */
+size_t oolong_element_get_string_length(oolong_element_t* element);
+
+/*
+ * Sets the element's content, which must be terminated. A different pointer
+ * being assigned to 'content' is noticed on its own, and terminated content
+ * rewritten in place, such as a clock printed into the same buffer, is noticed
+ * once the element has been rendered by comparing it with the rendered string.
+ */
+oolong_error_t oolong_element_set_content(oolong_element_t* element, wchar_t* content);
+
+/*
+ * Sets the element's content to the given number of characters starting at
+ * 'content', which need not be terminated. The characters are not copied, so an
+ * element can show part of a larger buffer the application owns for as long as
+ * that buffer lives.
+ */
+oolong_error_t oolong_element_set_content_slice(oolong_element_t* element, wchar_t* content, size_t length);
+
+/*
+ * Discards whatever is cached about the element's content from the given
+ * index onwards, for when content is edited in place, and takes the content's
+ * length after the edit. Everything before the index is kept so that, for
+ * example, typing at the end of a text box does not segment the whole content
+ * again.
+ */
+oolong_error_t oolong_element_invalidate_content(oolong_element_t* element, size_t from, size_t length);
+
+/*
+ * Gets the number of characters in the element's content, counting them unless
+ * the length was given with the content.
+ */
+size_t oolong_element_get_content_length(oolong_element_t* element);
+
+/*
+ * Gets the grapheme cluster boundaries of the element's content, finding them
+ * only if they are not already cached. Returns NULL on error. The returned
+ * cache belongs to the element and is valid until its content next changes.
+ */
+oolong_graphemes_t* oolong_element_get_graphemes(oolong_element_t* element);
+
+/*
+ * Gets the element's content word wrapped to the given number of columns. Line
+ * breaks are kept until the content or number of columns changes, so wrapping
+ * the same content to the same width every frame only costs a comparison.
+ * Returns NULL on error.
+ */
+oolong_wrap_t* oolong_element_get_wrap(oolong_element_t* element, unsigned int columns);
+
+/*
+ * Frees memory the element uses for cached information about its content and
+ * for styles of states other than normal, this does not free the element
+ * itself, its rendered string, nor the style sets.
+ */
+oolong_error_t oolong_element_destroy_caches(oolong_element_t* element);
+
+/*
+ * Resizes memory that belongs to the element, such as its rendered string,
+ * taking it from the element's arena if it has one and the heap otherwise.
+ * Behaves as oolong_arena_reallocate() does, the old size being needed only
+ * for arena memory.
+ */
+void* oolong_element_reallocate(oolong_element_t* element, void* pointer, size_t old_size, size_t size);
+
+/*
+ * Frees memory from oolong_element_reallocate().
+ */
+void oolong_element_free(oolong_element_t* element, void* pointer, size_t size);
+
+/*
+ * Frees the element's rendered string unless it is the element's inline
+ * string, leaving 'string' NULL.
+ */
+oolong_error_t oolong_element_free_string(oolong_element_t* element);
+
+/*
+ * Gets the number of terminal columns the element's content occupies, this
+ * accounts for wide and zero width characters unlike wcslen().
+ */
+size_t oolong_element_get_content_width(oolong_element_t* element);
+
+/*
+ * Gets the number of terminal columns the element's rendered string occupies,
+ * not counting any style escape sequences, as of its last render or measure.
+ */
+size_t oolong_element_get_string_width(oolong_element_t* element);
+
 /*
  * Sets the first found selected element's state to normal and makes the next 
  * element found to support the selected state selected. This function will 
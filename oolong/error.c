@@ -4,27 +4,40 @@
  */
 
 #include <stdio.h>
+#include <stdatomic.h>
 #include "error.h"
 
-static oolong_error_t recorded_errors = OOLONG_ERROR_NONE;
-static bool exit_on_error = true;
+/*
+ * Error state is thread local so that elements may be rendered from several
+ * threads at once, recording an error then never touches memory shared with
+ * another thread.
+ */
+
+static _Thread_local oolong_error_t recorded_errors = OOLONG_ERROR_NONE;
+static _Thread_local oolong_error_record_t last_error = { .error = OOLONG_ERROR_NONE };
+static atomic_bool exit_on_error = true;
 
 void oolong_error_set_exit_on_error(bool exit_on_error_value)
 {
-    exit_on_error = exit_on_error_value;
+    atomic_store_explicit(&exit_on_error, exit_on_error_value, memory_order_relaxed);
 }
 
 oolong_error_t oolong_error_debug_record(oolong_error_t error, const char* file, const char* function, size_t line)
 {
-    if (error == OOLONG_ERROR_NONE)
+    if (__builtin_expect(error == OOLONG_ERROR_NONE, true))
         return error;
 
-    if (exit_on_error)
+    if (atomic_load_explicit(&exit_on_error, memory_order_relaxed))
     {
         fprintf(stderr, "%s: line %zu of %s in %s\n", __func__, line, function, file);
         exit(EXIT_FAILURE);
     }
 
+    last_error.error = error;
+    last_error.file = file;
+    last_error.function = function;
+    last_error.line = line;
+
     recorded_errors |= error;
     return error;
 }
@@ -32,11 +45,15 @@ oolong_error_t oolong_error_debug_record(oolong_error_t error, const char* file,
 void oolong_error_clear_all(void)
 {
     recorded_errors = OOLONG_ERROR_NONE;
+    last_error.error = OOLONG_ERROR_NONE;
 }
 
 void oolong_error_clear(oolong_error_t error)
 {
     recorded_errors &= ~error;
+
+    if (last_error.error & error)
+        last_error.error = OOLONG_ERROR_NONE;
 }
 
 oolong_error_t oolong_error_get_all(void)
@@ -49,3 +66,7 @@ oolong_error_t oolong_error_check(oolong_error_t error)
     return recorded_errors & error;
 }
 
+oolong_error_record_t oolong_error_get_last(void)
+{
+    return last_error;
+}
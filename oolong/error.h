@@ -26,15 +26,31 @@ enum oolong_error_e
 };
 
 typedef enum oolong_error_e oolong_error_t;
+typedef struct oolong_error_record_s oolong_error_record_t;
 
 /*
- * Set whether or not oolong exits on errors.
+ * Where and what the last recorded error was. Like all other error state this
+ * is kept per thread, so an error recorded while rendering on one thread will
+ * never show up in, or race with, the error state of another.
+ */
+struct oolong_error_record_s
+{
+    oolong_error_t error;   /* The last recorded error, OOLONG_ERROR_NONE if there is none. */
+    const char* file;       /* Source file the error was recorded in. */
+    const char* function;   /* Function the error was recorded in. */
+    size_t line;            /* Line the error was recorded on. */
+};
+
+/*
+ * Set whether or not oolong exits on errors. Unlike recorded errors this
+ * setting is shared by all threads.
  */
 void oolong_error_set_exit_on_error(bool exit_on_error);
 
 /*
  * Records the given error, recording the same type of error twice, without
- * clearing errors inbetween, does nothing. Returns the recorded error.
+ * clearing errors inbetween, does nothing. Returns the recorded error. Errors
+ * are recorded for the calling thread only.
  *
  * This function should, in most cases, be called the moment an error is found
  * rather than have the error returned up a level and recorder there. This
@@ -72,5 +88,12 @@ oolong_error_t oolong_error_get_all(void);
  */
 oolong_error_t oolong_error_check(oolong_error_t error);
 
+/*
+ * Gets the file, function, and line at which the last error was recorded on
+ * the calling thread. Nothing is printed, if no error has been recorded since
+ * the last clear then the record's error is OOLONG_ERROR_NONE.
+ */
+oolong_error_record_t oolong_error_get_last(void);
+
 #endif // OOLONG_ERROR_H
 
@@ -0,0 +1,693 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+#include <string.h>
+#include <time.h>
+#include "memory.h"
+#include "screen.h"
+#include "width.h"
+#include "latency.h"
+#include "capture.h"
+#include "frame.h"
+
+#define ESCAPE L'\x1B'
+
+/* Characters compared at a time when looking for where a changed row starts to differ. */
+#define COMPARE_CHUNK 16
+
+/* Fewest rows a block must have to be moved by scrolling rather than written again. */
+#define MIN_SCROLL_ROWS 2
+
+/* Marks a screen row as showing none of the last frame's rows. */
+#define BLANK_ROW SIZE_MAX
+
+/*
+ * A row of a frame presented as rows, being the characters between two
+ * newlines of its output. Rows that changed from the last frame's row in the
+ * same place are hashed to look for where they moved from.
+ */
+struct row_s
+{
+	size_t start;
+	size_t length;
+	uint64_t hash;
+	bool changed;
+};
+
+static uint64_t frame_number = 0;
+static oolong_frame_stats_t history[OOLONG_FRAME_HISTORY];
+static size_t history_count = 0;
+static size_t history_next = 0;
+
+static oolong_frame_stats_t current;
+static uint64_t phase_start;
+static size_t allocations_start;
+
+/* 
+ * The compose file is kept open between frames and rewound at the start of
+ * each one, so its buffer only ever grows to fit the largest frame.
+ */
+static FILE* compose_file = NULL;
+static wchar_t* compose_buffer = NULL;
+static size_t compose_length = 0;
+
+/*
+ * Output reserved with oolong_frame_reserve() is written straight into this
+ * buffer, anything written to the compose file is moved into it first so that
+ * the two stay in order. It too only ever grows.
+ */
+static wchar_t* frame_buffer = NULL;
+static size_t frame_length = 0;
+static size_t frame_capacity = 0;
+
+/*
+ * The output and rows of the last frame presented as rows, kept to diff the
+ * next one against, along with the screen size it was presented to. The
+ * buffers are swapped rather than copied between frames and only ever grow.
+ */
+static wchar_t* previous_output = NULL;
+static size_t previous_output_capacity = 0;
+static struct row_s* previous_rows = NULL;
+static size_t previous_row_count = 0;
+static size_t previous_rows_capacity = 0;
+static struct row_s* rows = NULL;
+static size_t rows_capacity = 0;
+static bool rows_valid = false;
+static unsigned int rows_columns;
+static unsigned int rows_rows;
+
+/*
+ * A table of the last frame's changed rows by hash, used to find where changed
+ * rows of the current frame were. Only rows whose hash appears once are moved.
+ */
+struct row_entry_s
+{
+	uint64_t hash;
+	size_t row;
+	bool used;
+	bool unique;
+};
+
+static struct row_entry_s* row_table = NULL;
+static size_t row_table_capacity = 0;
+
+/* The last frame's row shown on each row of the screen once any scrolling is done, or BLANK_ROW. */
+static size_t* shown_rows = NULL;
+static size_t shown_rows_capacity = 0;
+
+/* Output of a frame presented as rows, only its changes. */
+static wchar_t* diff_buffer = NULL;
+static size_t diff_length = 0;
+static size_t diff_capacity = 0;
+
+static uint64_t get_time(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+FILE* oolong_frame_begin(void)
+{
+	if (compose_file == NULL)
+		compose_file = open_wmemstream(&compose_buffer, &compose_length);
+
+	if (compose_file == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+		return NULL;
+	}
+
+	rewind(compose_file);
+	frame_length = 0;
+
+	current = (oolong_frame_stats_t){ .frame = ++frame_number };
+	allocations_start = oolong_memory_get_allocations();
+	phase_start = get_time();
+	return compose_file;
+}
+
+oolong_error_t oolong_frame_end_phase(oolong_frame_phase_t phase)
+{
+	if (phase >= OOLONG_FRAME_PHASES)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	uint64_t now = get_time();
+	current.phase_times[phase] += now - phase_start;
+	phase_start = now;
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_frame_count_elements(size_t rendered, size_t reused)
+{
+	current.elements_rendered += rendered;
+	current.elements_reused += reused;
+	return OOLONG_ERROR_NONE;
+}
+
+/*
+ * Makes room for at least the given number of items of the given size in a
+ * buffer, at least doubling it whenever it grows.
+ */
+static oolong_error_t grow(void** buffer, size_t* capacity, size_t needed, size_t size)
+{
+	if (needed <= *capacity)
+		return OOLONG_ERROR_NONE;
+
+	size_t new_capacity = *capacity < 1024 ? 1024 : *capacity;
+
+	while (new_capacity < needed)
+		new_capacity *= 2;
+
+	void* new_buffer = oolong_memory_reallocate(*buffer, new_capacity, size);
+
+	if (new_buffer == NULL)
+		return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+	*buffer = new_buffer;
+	*capacity = new_capacity;
+	return OOLONG_ERROR_NONE;
+}
+
+/*
+ * Makes room for at least the given number of characters in the frame buffer.
+ */
+static oolong_error_t reserve_capacity(size_t capacity)
+{
+	return grow((void**)&frame_buffer, &frame_capacity, capacity, sizeof *frame_buffer);
+}
+
+/*
+ * Moves whatever was written to the compose file since it was last moved onto
+ * the end of the frame buffer.
+ */
+static oolong_error_t take_compose_file(void)
+{
+	/* Flushing updates the buffer and length, the buffer is not terminated after a rewind. */
+	fflush(compose_file);
+
+	if (compose_length == 0)
+		return OOLONG_ERROR_NONE;
+
+	oolong_error_t error = reserve_capacity(frame_length + compose_length);
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+
+	wmemcpy(&frame_buffer[frame_length], compose_buffer, compose_length);
+	frame_length += compose_length;
+	rewind(compose_file);
+	fflush(compose_file);
+	return OOLONG_ERROR_NONE;
+}
+
+wchar_t* oolong_frame_reserve(size_t length)
+{
+	if (compose_file == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return NULL;
+	}
+
+	if (take_compose_file() != OOLONG_ERROR_NONE || reserve_capacity(frame_length + length) != OOLONG_ERROR_NONE)
+		return NULL;
+
+	wchar_t* reserved = &frame_buffer[frame_length];
+	frame_length += length;
+	return reserved;
+}
+
+oolong_error_t oolong_frame_fill(wchar_t character, size_t count)
+{
+	if (count == 0)
+		return OOLONG_ERROR_NONE;
+
+	wchar_t* destination = oolong_frame_reserve(count);
+
+	if (destination == NULL)
+		return oolong_error_get_last().error;
+
+	wmemset(destination, character, count);
+	return OOLONG_ERROR_NONE;
+}
+
+/*
+ * Gets everything composed this frame, moving anything left in the compose
+ * file into the frame buffer if anything was reserved.
+ */
+static oolong_error_t get_output(wchar_t** output, size_t* output_length)
+{
+	/* A frame composed only through the file is written from the file's own buffer. */
+	if (frame_length == 0)
+	{
+		fflush(compose_file);
+		*output = compose_buffer;
+		*output_length = compose_length;
+		return OOLONG_ERROR_NONE;
+	}
+
+	oolong_error_t error = take_compose_file();
+	*output = frame_buffer;
+	*output_length = frame_length;
+	return error;
+}
+
+/*
+ * Writes the given output to the file as the write phase, then finishes the
+ * frame and records its statistics.
+ */
+static oolong_error_t write_output(FILE* file, const wchar_t* output, size_t output_length)
+{
+	const wchar_t* source = output;
+	mbstate_t state = { 0 };
+	size_t bytes = wcsnrtombs(NULL, &source, output_length, 0, &state);
+
+	for (size_t index = 0; index < output_length; index++)
+		current.escapes_written += output[index] == ESCAPE;
+
+	current.bytes_written = bytes == (size_t)-1 ? 0 : bytes;
+
+	fwprintf(file, L"%.*ls", (int)output_length, output);
+	fflush(file);
+	oolong_capture_output(output, output_length);
+
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_WRITE);
+	current.input_latency = oolong_latency_mark_presented();
+	current.allocations = oolong_memory_get_allocations() - allocations_start;
+
+	history[history_next] = current;
+	history_next = (history_next + 1) % OOLONG_FRAME_HISTORY;
+	history_count += history_count < OOLONG_FRAME_HISTORY;
+
+	if (ferror(file))
+		return oolong_error_record(OOLONG_ERROR_FAILED_IO_WRITE);
+
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_frame_present(FILE* file)
+{
+	if (file == NULL || compose_file == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	wchar_t* output;
+	size_t output_length;
+	oolong_error_t error = get_output(&output, &output_length);
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+
+	/* Whatever this frame drew is unknown to the next one presented as rows. */
+	rows_valid = false;
+	return write_output(file, output, output_length);
+}
+
+/*
+ * Splits the output into rows at its newlines.
+ */
+static oolong_error_t split_rows(const wchar_t* output, size_t output_length, size_t* row_count)
+{
+	size_t count = 0;
+	size_t start = 0;
+
+	for (size_t index = 0; index <= output_length; index++)
+	{
+		if (index < output_length && output[index] != L'\n')
+			continue;
+
+		/* Text after the last newline is a row only if there is some. */
+		if (index == output_length && index == start && count > 0)
+			break;
+
+		if (grow((void**)&rows, &rows_capacity, count + 1, sizeof *rows) != OOLONG_ERROR_NONE)
+			return oolong_error_get_last().error;
+
+		rows[count++] = (struct row_s){ .start = start, .length = index - start, .changed = true };
+		start = index + 1;
+	}
+
+	*row_count = count;
+	return OOLONG_ERROR_NONE;
+}
+
+/*
+ * Hashes a row with 64 bit FNV-1a.
+ */
+static uint64_t hash_row(const wchar_t* text, size_t length)
+{
+	uint64_t hash = 0xcbf29ce484222325;
+
+	for (size_t index = 0; index < length; index++)
+		hash = (hash ^ (uint64_t)text[index]) * 0x100000001b3;
+
+	return hash;
+}
+
+/*
+ * Checks whether a row of the output is the same as a row of the last frame,
+ * comparing their text with wmemcmp(), which the C library does with vector
+ * instructions and which stops at the first chunk that differs.
+ */
+static bool is_same_row(const wchar_t* output, struct row_s row, const struct row_s* previous)
+{
+	return row.length == previous->length && wmemcmp(&output[row.start], &previous_output[previous->start], row.length) == 0;
+}
+
+/*
+ * Gets the number of leading characters two rows have in common, comparing
+ * COMPARE_CHUNK characters at a time with memcmp(), which the C library does
+ * with vector instructions, before narrowing down the chunk that differs.
+ */
+static size_t get_common_prefix(const wchar_t* a, const wchar_t* b, size_t length)
+{
+	size_t prefix = 0;
+
+	while (prefix + COMPARE_CHUNK <= length && memcmp(&a[prefix], &b[prefix], COMPARE_CHUNK * sizeof *a) == 0)
+		prefix += COMPARE_CHUNK;
+
+	while (prefix < length && a[prefix] == b[prefix])
+		prefix++;
+
+	return prefix;
+}
+
+static oolong_error_t put_diff(const wchar_t* string, size_t length)
+{
+	if (grow((void**)&diff_buffer, &diff_capacity, diff_length + length, sizeof *diff_buffer) != OOLONG_ERROR_NONE)
+		return oolong_error_get_last().error;
+
+	wmemcpy(&diff_buffer[diff_length], string, length);
+	diff_length += length;
+	return OOLONG_ERROR_NONE;
+}
+
+static oolong_error_t put_diff_cursor_position(size_t column, size_t row)
+{
+	wchar_t escape[48];
+	int length = swprintf(escape, sizeof escape / sizeof *escape, L"\x1b[%zu;%zuH", row + 1, column + 1);
+	return put_diff(escape, length);
+}
+
+/*
+ * Looks for the longest block of rows that are the same as a block of the last
+ * frame's rows, only further up or down the screen, as a list scrolling or a
+ * log being followed gives. Each changed row is hashed and looked up in a
+ * table of the last frame's rows that changed, a row found there counting as
+ * moved only if its text is the same, and the block is the longest run of
+ * consecutive rows that all moved by the same distance. If it has at least MIN_SCROLL_ROWS rows the
+ * region of the screen covering where the block was and where it is, is
+ * scrolled by that distance and 'shown_rows' updated to match, so the rows
+ * are then compared against what is on screen after scrolling.
+ */
+static oolong_error_t scroll_rows(const wchar_t* output, size_t row_count, size_t shown_count)
+{
+	size_t table_size = 16;
+
+	while (table_size < 2 * shown_count)
+		table_size *= 2;
+
+	if (grow((void**)&row_table, &row_table_capacity, table_size, sizeof *row_table) != OOLONG_ERROR_NONE)
+		return oolong_error_get_last().error;
+
+	memset(row_table, 0, table_size * sizeof *row_table);
+
+	for (size_t row = 0; row < shown_count; row++)
+	{
+		/* A row still in the same place has not moved anywhere. */
+		if (row < row_count && !rows[row].changed)
+			continue;
+
+		previous_rows[row].hash = hash_row(&previous_output[previous_rows[row].start], previous_rows[row].length);
+		size_t slot = previous_rows[row].hash & (table_size - 1);
+
+		while (row_table[slot].used && row_table[slot].hash != previous_rows[row].hash)
+			slot = (slot + 1) & (table_size - 1);
+
+		row_table[slot].unique = !row_table[slot].used;
+		row_table[slot] = (struct row_entry_s){ .hash = previous_rows[row].hash, .row = row, .used = true, .unique = row_table[slot].unique };
+	}
+
+	size_t best_start = 0;
+	size_t best_length = 0;
+	ptrdiff_t best_distance = 0;
+	size_t run_start = 0;
+	size_t run_length = 0;
+	ptrdiff_t run_distance = 0;
+
+	for (size_t row = 0; row < row_count; row++)
+	{
+		ptrdiff_t distance = 0;
+		size_t slot = 0;
+
+		if (rows[row].changed)
+		{
+			rows[row].hash = hash_row(&output[rows[row].start], rows[row].length);
+			slot = rows[row].hash & (table_size - 1);
+
+			while (row_table[slot].used && row_table[slot].hash != rows[row].hash)
+				slot = (slot + 1) & (table_size - 1);
+		}
+
+		/* A matching hash only finds where the row might have been, its text is checked to be sure. */
+		if (rows[row].changed && row_table[slot].used && row_table[slot].unique && is_same_row(output, rows[row], &previous_rows[row_table[slot].row]))
+			distance = (ptrdiff_t)row_table[slot].row - (ptrdiff_t)row;
+
+		if (distance != 0 && run_length > 0 && distance == run_distance)
+		{
+			run_length++;
+		}
+		else
+		{
+			run_start = row;
+			run_length = distance != 0;
+			run_distance = distance;
+		}
+
+		if (run_length > best_length)
+		{
+			best_start = run_start;
+			best_length = run_length;
+			best_distance = run_distance;
+		}
+	}
+
+	if (best_length < MIN_SCROLL_ROWS)
+		return OOLONG_ERROR_NONE;
+
+	/* Moving up scrolls the region from the block's new top to its old bottom, moving down the other way around. */
+	size_t amount = best_distance > 0 ? (size_t)best_distance : (size_t)-best_distance;
+	size_t top = best_distance > 0 ? best_start : best_start - amount;
+	size_t bottom = best_distance > 0 ? best_start + best_length + amount - 1 : best_start + best_length - 1;
+
+	wchar_t escape[64];
+	int length = swprintf(escape, sizeof escape / sizeof *escape, L"\x1b[%zu;%zur\x1b[%zu%lc\x1b[r", top + 1, bottom + 1, amount, best_distance > 0 ? L'S' : L'T');
+	oolong_error_t error = put_diff(escape, length);
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+
+	if (best_distance > 0)
+	{
+		for (size_t row = top; row <= bottom; row++)
+			shown_rows[row] = row + amount <= bottom ? shown_rows[row + amount] : BLANK_ROW;
+	}
+	else
+	{
+		for (size_t row = bottom + 1; row-- > top;)
+			shown_rows[row] = row >= top + amount ? shown_rows[row - amount] : BLANK_ROW;
+	}
+
+	current.rows_scrolled = best_length;
+	return OOLONG_ERROR_NONE;
+}
+
+/*
+ * Puts the part of a changed row that differs from the row of the last frame
+ * shown where it goes, if any, followed by erasing the rest of the line. The
+ * unchanged start of the row is only skipped if it holds no escape sequences,
+ * since otherwise the style in effect and the column where it ends are not
+ * known.
+ */
+static oolong_error_t put_changed_row(const wchar_t* output, struct row_s row, size_t row_index, const struct row_s* previous)
+{
+	const wchar_t* text = &output[row.start];
+	size_t prefix = 0;
+
+	if (previous != NULL)
+	{
+		prefix = get_common_prefix(text, &previous_output[previous->start], row.length < previous->length ? row.length : previous->length);
+
+		/* Starting on a combining character would separate it from its base. */
+		while (prefix > 0 && prefix < row.length && oolong_width_of_char(text[prefix]) == 0)
+			prefix--;
+
+		if (wmemchr(text, ESCAPE, prefix) != NULL)
+			prefix = 0;
+	}
+
+	oolong_error_t error = put_diff_cursor_position(oolong_width_of_string(text, prefix), row_index);
+
+	if (error == OOLONG_ERROR_NONE)
+		error = put_diff(&text[prefix], row.length - prefix);
+
+	if (error == OOLONG_ERROR_NONE)
+		error = put_diff(L"\x1b[K", 3);
+
+	current.rows_written++;
+	return error;
+}
+
+oolong_error_t oolong_frame_present_rows(FILE* file)
+{
+	if (file == NULL || compose_file == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	wchar_t* output;
+	size_t output_length;
+	size_t row_count;
+	oolong_error_t error = get_output(&output, &output_length);
+
+	if (error != OOLONG_ERROR_NONE || (error = split_rows(output, output_length, &row_count)) != OOLONG_ERROR_NONE)
+		return error;
+
+	unsigned int columns, screen_rows;
+	oolong_get_screen_dimensions(&columns, &screen_rows);
+
+	/* Rows past the bottom of the screen cannot be moved to, so they are left out. */
+	row_count = row_count < screen_rows ? row_count : screen_rows;
+	diff_length = 0;
+
+	/* Without a last frame on a screen of the same size there is nothing to diff against. */
+	if (!rows_valid || rows_columns != columns || rows_rows != screen_rows)
+	{
+		error = put_diff(L"\x1b[H\x1b[2J", 7);
+
+		/* No newline follows the last row, which would scroll a frame as tall as the screen. */
+		for (size_t index = 0; index < row_count && error == OOLONG_ERROR_NONE; index++)
+		{
+			if (index > 0)
+				error = put_diff(L"\n", 1);
+
+			if (error == OOLONG_ERROR_NONE)
+				error = put_diff(&output[rows[index].start], rows[index].length);
+		}
+
+		current.rows_written = row_count;
+	}
+	else
+	{
+		size_t shown_count = previous_row_count < screen_rows ? previous_row_count : screen_rows;
+
+		if (grow((void**)&shown_rows, &shown_rows_capacity, screen_rows, sizeof *shown_rows) != OOLONG_ERROR_NONE)
+			return oolong_error_get_last().error;
+
+		size_t changed = 0;
+
+		for (size_t index = 0; index < screen_rows; index++)
+			shown_rows[index] = index < shown_count ? index : BLANK_ROW;
+
+		for (size_t index = 0; index < row_count; index++)
+		{
+			rows[index].changed = index >= shown_count || !is_same_row(output, rows[index], &previous_rows[index]);
+			changed += rows[index].changed;
+		}
+
+		/* Only with enough changed rows could any block of them have moved. */
+		if (changed >= MIN_SCROLL_ROWS)
+			error = scroll_rows(output, row_count, shown_count);
+
+		for (size_t index = 0; index < row_count && error == OOLONG_ERROR_NONE; index++)
+		{
+			const struct row_s* previous = shown_rows[index] != BLANK_ROW ? &previous_rows[shown_rows[index]] : NULL;
+			bool same;
+
+			/* Rows left where they were have already been compared. */
+			if (previous == NULL)
+				same = rows[index].length == 0;
+			else if (shown_rows[index] == index)
+				same = !rows[index].changed;
+			else
+				same = is_same_row(output, rows[index], previous);
+
+			if (same)
+			{
+				current.rows_skipped++;
+				continue;
+			}
+
+			error = put_changed_row(output, rows[index], index, previous);
+		}
+
+		/* Rows the last frame had and this one does not are erased. */
+		for (size_t index = row_count; index < shown_count && error == OOLONG_ERROR_NONE; index++)
+		{
+			if (shown_rows[index] == BLANK_ROW || previous_rows[shown_rows[index]].length == 0)
+				continue;
+
+			error = put_diff_cursor_position(0, index);
+
+			if (error == OOLONG_ERROR_NONE)
+				error = put_diff(L"\x1b[K", 3);
+		}
+	}
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+
+	/* This frame's output becomes the last frame's, swapping buffers when it is the frame buffer. */
+	if (output == frame_buffer)
+	{
+		wchar_t* swapped = previous_output;
+		size_t swapped_capacity = previous_output_capacity;
+		previous_output = frame_buffer;
+		previous_output_capacity = frame_capacity;
+		frame_buffer = swapped;
+		frame_capacity = swapped_capacity;
+	}
+	else
+	{
+		if (grow((void**)&previous_output, &previous_output_capacity, output_length, sizeof *previous_output) != OOLONG_ERROR_NONE)
+			return oolong_error_get_last().error;
+
+		wmemcpy(previous_output, output, output_length);
+	}
+
+	struct row_s* swapped_rows = previous_rows;
+	size_t swapped_rows_capacity = previous_rows_capacity;
+	previous_rows = rows;
+	previous_rows_capacity = rows_capacity;
+	previous_row_count = row_count;
+	rows = swapped_rows;
+	rows_capacity = swapped_rows_capacity;
+
+	rows_valid = true;
+	rows_columns = columns;
+	rows_rows = screen_rows;
+	return write_output(file, diff_buffer, diff_length);
+}
+
+oolong_error_t oolong_frame_get_stats(size_t frames_ago, oolong_frame_stats_t* stats)
+{
+	if (stats == NULL || frames_ago >= history_count)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	*stats = history[(history_next + OOLONG_FRAME_HISTORY - 1 - frames_ago) % OOLONG_FRAME_HISTORY];
+	return OOLONG_ERROR_NONE;
+}
+
+size_t oolong_frame_get_stats_count(void)
+{
+	return history_count;
+}
+
+oolong_error_t oolong_frame_reset_stats(void)
+{
+	history_count = 0;
+	history_next = 0;
+	return OOLONG_ERROR_NONE;
+}
@@ -0,0 +1,128 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_FRAME_H
+#define OOLONG_FRAME_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <wchar.h>
+#include "error.h"
+
+/* Number of past frames whose statistics are kept. */
+#define OOLONG_FRAME_HISTORY 64
+
+/*
+ * A frame is printed in phases, one after the other. Layout works out sizes
+ * and positions, render renders each element to its string, compose arranges
+ * the rendered strings into the frame's output, and write sends that output to
+ * the file being printed to.
+ */
+enum oolong_frame_phase_e
+{
+	OOLONG_FRAME_PHASE_LAYOUT,
+	OOLONG_FRAME_PHASE_RENDER,
+	OOLONG_FRAME_PHASE_COMPOSE,
+	OOLONG_FRAME_PHASE_WRITE,
+	OOLONG_FRAME_PHASES
+};
+
+typedef enum oolong_frame_phase_e oolong_frame_phase_t;
+typedef struct oolong_frame_stats_s oolong_frame_stats_t;
+
+struct oolong_frame_stats_s
+{
+	uint64_t frame;								/* Sequence number of the frame, the first being 1. */
+	uint64_t phase_times[OOLONG_FRAME_PHASES];	/* Wall time spent in each phase in nanoseconds, indexed by phase. */
+	size_t elements_rendered;					/* Elements rendered this frame. */
+	size_t elements_reused;						/* Elements whose string from an earlier frame was used as is. */
+	size_t bytes_written;						/* Bytes of output written. */
+	size_t escapes_written;						/* Escape sequences in the output. */
+	size_t rows_written;						/* Rows written by a frame presented as rows, all of them if it was drawn in full. */
+	size_t rows_skipped;						/* Rows of a frame presented as rows left as they were. */
+	size_t rows_scrolled;						/* Rows of a frame presented as rows moved into place by scrolling. */
+	size_t allocations;							/* Heap allocations made by oolong, on any thread, during the frame. */
+	uint64_t input_latency;						/* Nanoseconds from the first key since the last frame until this one was written, 0 if none. */
+};
+
+/*
+ * Begins a new frame and its layout phase, returning the file its output
+ * should be composed into. Frames are tracked for the whole process, so only
+ * one thread should print at a time. This and the functions below are used by
+ * views and need only be called when printing something by hand.
+ */
+FILE* oolong_frame_begin(void);
+
+/*
+ * Ends the current phase, adding the time since the previous phase ended (or
+ * the frame began) to it, and moves on to the next phase.
+ */
+oolong_error_t oolong_frame_end_phase(oolong_frame_phase_t phase);
+
+/*
+ * Reserves room for the given number of characters at the end of the current
+ * frame's output and returns it to be written into directly, anything already
+ * written to the frame's file coming before it. The characters must all be
+ * written, no terminator is needed. The returned pointer is only valid until
+ * the next reservation or the frame is presented. Returns NULL on failure.
+ */
+wchar_t* oolong_frame_reserve(size_t length);
+
+/*
+ * Puts the given number of the same character, such as spaces or newlines,
+ * into the current frame's output.
+ */
+oolong_error_t oolong_frame_fill(wchar_t character, size_t count);
+
+/*
+ * Adds to the current frame's counts of rendered and reused elements.
+ */
+oolong_error_t oolong_frame_count_elements(size_t rendered, size_t reused);
+
+/*
+ * Writes everything composed this frame to the given file, and queues it for
+ * the capture if one is running (see capture.h), as the write phase. Then
+ * finishes the frame and records its statistics.
+ */
+oolong_error_t oolong_frame_present(FILE* file);
+
+/*
+ * Writes only the rows of the current frame that changed since the last frame
+ * presented this way, as the write phase, then finishes the frame as
+ * oolong_frame_present() does. This suits frames that are a whole screen
+ * composed a line at a time from the top, such as stack and grid views, and
+ * which fit on the screen.
+ *
+ * Each row of the frame, the text between two newlines, is compared with the
+ * same row of the last frame, and skipped if it is the same. A changed row is
+ * compared with the last frame's a chunk at a time to find where it starts to
+ * differ, and from there it is written after moving the cursor to that column
+ * and the rest of the line is erased. Before that the changed rows are hashed
+ * and looked up among the last frame's, and if a block of them has moved up or
+ * down, as when a list scrolls, the part of the screen it covers is scrolled
+ * with a scroll region so that only the rows scrolled in need writing. The first
+ * frame, any after one presented otherwise, and any after the screen is
+ * resized clear the screen and are written in full, as far as its last row.
+ */
+oolong_error_t oolong_frame_present_rows(FILE* file);
+
+/*
+ * Copies the statistics of a past frame into 'stats', 0 being the most recent
+ * frame, 1 the one before it, and so on up to OOLONG_FRAME_HISTORY - 1. Fails
+ * with OOLONG_ERROR_INVALID_ARGUMENT if that frame was not kept.
+ */
+oolong_error_t oolong_frame_get_stats(size_t frames_ago, oolong_frame_stats_t* stats);
+
+/*
+ * Gets the number of frames whose statistics can currently be read.
+ */
+size_t oolong_frame_get_stats_count(void);
+
+/*
+ * Forgets the statistics of every past frame, frame numbers keep counting up.
+ */
+oolong_error_t oolong_frame_reset_stats(void);
+
+#endif // OOLONG_FRAME_H
@@ -0,0 +1,226 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stdint.h>
+#include "memory.h"
+#include "width.h"
+#include "grapheme.h"
+
+#define ZERO_WIDTH_NON_JOINER 0x200C
+#define ZERO_WIDTH_JOINER 0x200D
+
+static bool is_control(uint32_t code_point)
+{
+	return code_point < 0x20
+		|| (code_point >= 0x7F && code_point < 0xA0)
+		|| code_point == 0xAD
+		|| code_point == 0x200B
+		|| code_point == 0x200E
+		|| code_point == 0x200F
+		|| (code_point >= 0x2028 && code_point <= 0x202E)
+		|| (code_point >= 0x2060 && code_point <= 0x206F)
+		|| code_point == 0xFEFF;
+}
+
+static bool is_extend(uint32_t code_point)
+{
+	if (code_point == ZERO_WIDTH_NON_JOINER || code_point == ZERO_WIDTH_JOINER)
+		return true;
+
+	/* Emoji skin tone modifiers. */
+	if (code_point >= 0x1F3FB && code_point <= 0x1F3FF)
+		return true;
+
+	return !is_control(code_point) && oolong_width_of_char(code_point) == 0;
+}
+
+static bool is_regional_indicator(uint32_t code_point)
+{
+	return code_point >= 0x1F1E6 && code_point <= 0x1F1FF;
+}
+
+bool oolong_grapheme_is_pictographic(wchar_t character)
+{
+	uint32_t code_point = (uint32_t)character;
+
+	return code_point == 0xA9
+		|| code_point == 0xAE
+		|| (code_point >= 0x2190 && code_point <= 0x21FF)
+		|| (code_point >= 0x2300 && code_point <= 0x23FF)
+		|| (code_point >= 0x2600 && code_point <= 0x27BF)
+		|| (code_point >= 0x2B00 && code_point <= 0x2BFF)
+		|| (code_point >= 0x1F000 && code_point <= 0x1FAFF);
+}
+
+size_t oolong_grapheme_next_boundary(const wchar_t* text, size_t length, size_t offset)
+{
+	if (text == NULL || offset >= length)
+		return length;
+
+	uint32_t first = text[offset];
+	size_t index = offset + 1;
+
+	if (first == L'\r' && index < length && text[index] == L'\n')
+		return index + 1;
+
+	if (is_control(first))
+		return index;
+
+	/* Regional indicators make up flags in pairs. */
+	if (is_regional_indicator(first) && index < length && is_regional_indicator(text[index]))
+		index++;
+
+	while (index < length)
+	{
+		if (is_extend(text[index]))
+		{
+			index++;
+			continue;
+		}
+
+		if ((uint32_t)text[index - 1] == ZERO_WIDTH_JOINER && oolong_grapheme_is_pictographic(text[index]))
+		{
+			index++;
+			continue;
+		}
+
+		break;
+	}
+
+	return index;
+}
+
+static oolong_error_t push_boundary(oolong_graphemes_t* graphemes, size_t boundary)
+{
+	if (graphemes->count == graphemes->capacity)
+	{
+		size_t capacity = graphemes->capacity ? graphemes->capacity * 2 : 16;
+		size_t* new_boundaries = oolong_memory_reallocate(graphemes->boundaries, capacity, sizeof *graphemes->boundaries);
+
+		if (new_boundaries == NULL)
+			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+		graphemes->boundaries = new_boundaries;
+		graphemes->capacity = capacity;
+	}
+
+	graphemes->boundaries[graphemes->count] = boundary;
+	graphemes->count++;
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_graphemes_update(oolong_graphemes_t* graphemes, const wchar_t* text, size_t length)
+{
+	if (graphemes == NULL || (text == NULL && length > 0))
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (graphemes->source != text)
+	{
+		graphemes->source = text;
+		graphemes->length = 0;
+		graphemes->count = 0;
+	}
+	else if (length != graphemes->length)
+	{
+		/* 
+		 * Whether the text grew or shrank only its last cluster could have been
+		 * changed, anything past the new end is simply gone.
+		 */
+
+		oolong_graphemes_invalidate_from(graphemes, length < graphemes->length ? length : graphemes->length);
+	}
+
+	while (graphemes->length < length)
+	{
+		oolong_error_t error = push_boundary(graphemes, graphemes->length);
+
+		if (error != OOLONG_ERROR_NONE)
+			return error;
+
+		graphemes->length = oolong_grapheme_next_boundary(text, length, graphemes->length);
+	}
+
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_graphemes_invalidate_from(oolong_graphemes_t* graphemes, size_t offset)
+{
+	if (graphemes == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (offset > graphemes->length)
+		return OOLONG_ERROR_NONE;
+
+	if (offset == 0 || graphemes->count == 0)
+	{
+		graphemes->length = 0;
+		graphemes->count = 0;
+		return OOLONG_ERROR_NONE;
+	}
+
+	graphemes->count = oolong_graphemes_find(graphemes, offset - 1);
+	graphemes->length = graphemes->boundaries[graphemes->count];
+	return OOLONG_ERROR_NONE;
+}
+
+size_t oolong_graphemes_find(oolong_graphemes_t* graphemes, size_t offset)
+{
+	if (graphemes == NULL || graphemes->count == 0)
+		return 0;
+
+	if (offset >= graphemes->length)
+		return graphemes->count;
+
+	size_t low = 0;
+	size_t high = graphemes->count;
+
+	/* Finds the last cluster starting at or before the offset. */
+	while (high - low > 1)
+	{
+		size_t middle = low + (high - low) / 2;
+
+		if (graphemes->boundaries[middle] <= offset)
+			low = middle;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+size_t oolong_graphemes_get_start(oolong_graphemes_t* graphemes, size_t cluster)
+{
+	if (graphemes == NULL || cluster > graphemes->count)
+	{
+		oolong_error_record(OOLONG_ERROR_NO_SUCH_ELEMENT);
+		return 0;
+	}
+
+	if (cluster == graphemes->count)
+		return graphemes->length;
+
+	return graphemes->boundaries[cluster];
+}
+
+size_t oolong_graphemes_get_length(oolong_graphemes_t* graphemes, size_t cluster)
+{
+	if (graphemes == NULL || cluster >= graphemes->count)
+	{
+		oolong_error_record(OOLONG_ERROR_NO_SUCH_ELEMENT);
+		return 0;
+	}
+
+	return oolong_graphemes_get_start(graphemes, cluster + 1) - graphemes->boundaries[cluster];
+}
+
+oolong_error_t oolong_graphemes_destroy(oolong_graphemes_t* graphemes)
+{
+	if (graphemes == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	oolong_memory_free(graphemes->boundaries);
+	*graphemes = (oolong_graphemes_t){ 0 };
+	return OOLONG_ERROR_NONE;
+}
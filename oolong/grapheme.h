@@ -0,0 +1,86 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_GRAPHEME_H
+#define OOLONG_GRAPHEME_H
+
+#include <wchar.h>
+#include <stdbool.h>
+#include "error.h"
+
+typedef struct oolong_graphemes_s oolong_graphemes_t;
+
+/*
+ * The grapheme cluster boundaries of some text, a grapheme cluster being what
+ * a user would consider a single character, e.g. a letter with combining
+ * accents, a flag, or an emoji ZWJ sequence. Boundaries are found lazily and
+ * kept until the text changes, a zero initialized struct is an empty cache.
+ *
+ * Clusters are addressed by index so that stepping to the next or previous
+ * cluster is a single array access.
+ */
+struct oolong_graphemes_s
+{
+	const wchar_t* source;	/* Text the boundaries were found in. */
+	size_t length;			/* Number of characters of the source that have been segmented. */
+	size_t count;			/* Number of clusters found. */
+	size_t capacity;		/* Number of offsets 'boundaries' has room for. */
+	size_t* boundaries;		/* Index of the first character of each cluster. */
+};
+
+/*
+ * Finds the end of the grapheme cluster starting at the given offset, that is,
+ * the offset of the next cluster. This is a simplified form of the Unicode
+ * extended grapheme cluster rules covering CR LF, control characters,
+ * combining marks and other extending characters, emoji modifiers and ZWJ
+ * sequences, and regional indicator pairs.
+ */
+size_t oolong_grapheme_next_boundary(const wchar_t* text, size_t length, size_t offset);
+
+/*
+ * Checks whether the character is an emoji or other pictograph that may be
+ * joined into a larger cluster by a zero width joiner.
+ */
+bool oolong_grapheme_is_pictographic(wchar_t character);
+
+/*
+ * Brings the cached boundaries up to date with the given text. Nothing is done
+ * if the text and length are the same as those last given and no part of the
+ * cache was invalidated. Text that has only been appended to or truncated is
+ * segmented again from its last cluster only, any other change to the text in
+ * place must be reported with oolong_graphemes_invalidate_from().
+ */
+oolong_error_t oolong_graphemes_update(oolong_graphemes_t* graphemes, const wchar_t* text, size_t length);
+
+/*
+ * Discards the boundaries of clusters that may be affected by a change to the
+ * text at the given offset or later. The cluster before the change is dropped
+ * as well since, for example, an inserted combining mark joins it.
+ */
+oolong_error_t oolong_graphemes_invalidate_from(oolong_graphemes_t* graphemes, size_t offset);
+
+/*
+ * Gets the index of the cluster containing the given character offset.
+ */
+size_t oolong_graphemes_find(oolong_graphemes_t* graphemes, size_t offset);
+
+/*
+ * Gets the offset of the first character of the given cluster. The cluster
+ * index equal to the number of clusters gives the end of the text.
+ */
+size_t oolong_graphemes_get_start(oolong_graphemes_t* graphemes, size_t cluster);
+
+/*
+ * Gets the number of characters in the given cluster.
+ */
+size_t oolong_graphemes_get_length(oolong_graphemes_t* graphemes, size_t cluster);
+
+/*
+ * Frees the memory used by the cache and resets it to empty, the struct itself
+ * is not freed.
+ */
+oolong_error_t oolong_graphemes_destroy(oolong_graphemes_t* graphemes);
+
+#endif // OOLONG_GRAPHEME_H
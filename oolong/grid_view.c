@@ -0,0 +1,389 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "memory.h"
+#include "screen.h"
+#include "frame.h"
+#include "grid_view.h"
+
+/* Width of a cell that has not been measured since it was set. */
+#define UNMEASURED SIZE_MAX
+
+struct oolong_grid_view_s
+{
+	oolong_grid_view_options_t options;
+	oolong_grid_cell_t* cells;				/* Row major, 'column_count' cells to a row. */
+	size_t* cell_widths;					/* Width each cell was last measured at, or UNMEASURED. */
+	size_t* column_natural_widths;			/* Widest measured cell of each column. */
+	bool* column_changed;					/* Set for columns with a cell whose width changed this print. */
+	unsigned int* column_widths;			/* Width each column was last laid out with. */
+	size_t* row_heights;					/* Height of each row this print. */
+	oolong_stack_view_cursor_t* cursors;	/* Cursor of each column's stack view in the row being composed. */
+	unsigned int laid_out_columns;			/* Screen columns the column widths were worked out for. */
+	bool laid_out;							/* Set once the column widths have been worked out. */
+	size_t cells_measured;
+};
+
+oolong_grid_view_t* oolong_grid_view_create(oolong_grid_view_options_t* options)
+{
+	if (options == NULL || options->columns == NULL || options->column_count == 0 || options->row_count == 0)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return NULL;
+	}
+
+	size_t column_count = options->column_count;
+	size_t cell_count = column_count * options->row_count;
+	oolong_grid_view_t* grid = oolong_memory_allocate_zeroed(1, sizeof *grid);
+
+	if (grid == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+		return NULL;
+	}
+
+	grid->options = *options;
+	grid->options.columns = oolong_memory_allocate(column_count * sizeof *grid->options.columns);
+	grid->cells = oolong_memory_allocate_zeroed(cell_count, sizeof *grid->cells);
+	grid->cell_widths = oolong_memory_allocate(cell_count * sizeof *grid->cell_widths);
+	grid->column_natural_widths = oolong_memory_allocate_zeroed(column_count, sizeof *grid->column_natural_widths);
+	grid->column_changed = oolong_memory_allocate_zeroed(column_count, sizeof *grid->column_changed);
+	grid->column_widths = oolong_memory_allocate_zeroed(column_count, sizeof *grid->column_widths);
+	grid->row_heights = oolong_memory_allocate_zeroed(options->row_count, sizeof *grid->row_heights);
+	grid->cursors = oolong_memory_allocate_zeroed(column_count, sizeof *grid->cursors);
+
+	if (grid->options.columns == NULL || grid->cells == NULL || grid->cell_widths == NULL || grid->column_natural_widths == NULL
+		|| grid->column_changed == NULL || grid->column_widths == NULL || grid->row_heights == NULL || grid->cursors == NULL)
+	{
+		oolong_grid_view_destroy(grid);
+		oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+		return NULL;
+	}
+
+	memcpy(grid->options.columns, options->columns, column_count * sizeof *grid->options.columns);
+
+	for (size_t index = 0; index < cell_count; index++)
+		grid->cell_widths[index] = UNMEASURED;
+
+	return grid;
+}
+
+oolong_error_t oolong_grid_view_destroy(oolong_grid_view_t* grid)
+{
+	if (grid == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	oolong_memory_free(grid->options.columns);
+	oolong_memory_free(grid->cells);
+	oolong_memory_free(grid->cell_widths);
+	oolong_memory_free(grid->column_natural_widths);
+	oolong_memory_free(grid->column_changed);
+	oolong_memory_free(grid->column_widths);
+	oolong_memory_free(grid->row_heights);
+	oolong_memory_free(grid->cursors);
+	oolong_memory_free(grid);
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_grid_view_set_cell(oolong_grid_view_t* grid, size_t column, size_t row, oolong_grid_cell_t cell)
+{
+	if (grid == NULL || column >= grid->options.column_count || row >= grid->options.row_count || (cell.element != NULL && cell.view != NULL))
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	size_t index = row * grid->options.column_count + column;
+	grid->cells[index] = cell;
+	grid->cell_widths[index] = UNMEASURED;
+	return OOLONG_ERROR_NONE;
+}
+
+unsigned int oolong_grid_view_get_column_width(oolong_grid_view_t* grid, size_t column)
+{
+	if (grid == NULL || column >= grid->options.column_count)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	return grid->column_widths[column];
+}
+
+size_t oolong_grid_view_get_cells_measured(oolong_grid_view_t* grid)
+{
+	if (grid == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	return grid->cells_measured;
+}
+
+/*
+ * Renders every element in the grid's cells, marking the columns of cells with
+ * an element that was rendered again to have them measured.
+ */
+static oolong_error_t render(oolong_grid_view_t* grid)
+{
+	size_t cell_count = grid->options.column_count * grid->options.row_count;
+	size_t rendered = 0;
+	size_t reused = 0;
+
+	for (size_t index = 0; index < cell_count; index++)
+	{
+		oolong_grid_cell_t* cell = &grid->cells[index];
+		size_t cell_rendered = 0;
+
+		if (cell->element != NULL)
+		{
+			oolong_error_t error = oolong_element_render_string(cell->element);
+
+			if (error != OOLONG_ERROR_NONE)
+				return error;
+
+			cell_rendered += !cell->element->reused;
+			reused += cell->element->reused;
+		}
+		else if (cell->view != NULL && cell->view->elements != NULL)
+		{
+			oolong_error_t error = oolong_element_render_strings(cell->view->elements, cell->view->render_threads);
+
+			if (error != OOLONG_ERROR_NONE)
+				return error;
+
+			for (size_t element = 0; cell->view->elements[element]; element++)
+			{
+				cell_rendered += !cell->view->elements[element]->reused;
+				reused += cell->view->elements[element]->reused;
+			}
+		}
+
+		/* A reused element's width cannot have changed, so neither has its cell's. */
+		if (cell_rendered > 0)
+			grid->cell_widths[index] = UNMEASURED;
+
+		rendered += cell_rendered;
+	}
+
+	return oolong_frame_count_elements(rendered, reused);
+}
+
+/*
+ * Measures cells set or changed since the last print, and works out again the
+ * natural width of any column one of them changed. Returns whether any column's
+ * natural width changed.
+ */
+static bool measure(oolong_grid_view_t* grid)
+{
+	size_t column_count = grid->options.column_count;
+	size_t cell_count = column_count * grid->options.row_count;
+	bool changed = false;
+
+	grid->cells_measured = 0;
+
+	for (size_t index = 0; index < cell_count; index++)
+	{
+		if (grid->cell_widths[index] != UNMEASURED)
+			continue;
+
+		oolong_grid_cell_t* cell = &grid->cells[index];
+		size_t width = 0;
+
+		if (cell->element != NULL)
+			width = oolong_element_get_string_width(cell->element);
+		else if (cell->view != NULL && cell->view->elements != NULL)
+			width = oolong_stack_view_get_width(cell->view);
+
+		grid->cell_widths[index] = width;
+		grid->column_changed[index % column_count] = true;
+		grid->cells_measured++;
+	}
+
+	for (size_t column = 0; column < column_count; column++)
+	{
+		if (!grid->column_changed[column])
+			continue;
+
+		size_t natural_width = 0;
+
+		for (size_t index = column; index < cell_count; index += column_count)
+			natural_width = grid->cell_widths[index] > natural_width ? grid->cell_widths[index] : natural_width;
+
+		changed |= natural_width != grid->column_natural_widths[column];
+		grid->column_natural_widths[column] = natural_width;
+		grid->column_changed[column] = false;
+	}
+
+	return changed;
+}
+
+/*
+ * Works out the width of every column from the columns available to the grid.
+ */
+static void lay_out_columns(oolong_grid_view_t* grid, unsigned int available)
+{
+	size_t column_count = grid->options.column_count;
+	unsigned int used = 0;
+	unsigned int total_weight = 0;
+
+	for (size_t column = 0; column < column_count; column++)
+	{
+		oolong_grid_column_t* sizing = &grid->options.columns[column];
+		unsigned int width = 0;
+
+		switch (sizing->sizing)
+		{
+			case (OOLONG_GRID_SIZE_AUTO):		width = grid->column_natural_widths[column];	break;
+			case (OOLONG_GRID_SIZE_FIXED):		width = sizing->size;							break;
+			case (OOLONG_GRID_SIZE_FRACTION):	total_weight += sizing->size;					break;
+		}
+
+		/* Columns past the edge of the screen are squeezed rather than overflowing it. */
+		width = width > available - used ? available - used : width;
+		grid->column_widths[column] = width;
+		used += width;
+	}
+
+	unsigned int remaining = available - used;
+	unsigned int shared = 0;
+
+	for (size_t column = 0; column < column_count && total_weight > 0; column++)
+	{
+		if (grid->options.columns[column].sizing != OOLONG_GRID_SIZE_FRACTION)
+			continue;
+
+		grid->column_widths[column] = (unsigned long long)remaining * grid->options.columns[column].size / total_weight;
+		shared += grid->column_widths[column];
+	}
+
+	/* Whatever rounding left over goes one column at a time to the first fractional columns. */
+	for (size_t column = 0; column < column_count && shared < remaining && total_weight > 0; column++)
+	{
+		if (grid->options.columns[column].sizing != OOLONG_GRID_SIZE_FRACTION || grid->options.columns[column].size == 0)
+			continue;
+
+		grid->column_widths[column]++;
+		shared++;
+	}
+}
+
+/*
+ * Works out the height of each row from the cells in it at their columns' widths.
+ */
+static void lay_out_rows(oolong_grid_view_t* grid)
+{
+	size_t column_count = grid->options.column_count;
+
+	for (size_t row = 0; row < grid->options.row_count; row++)
+	{
+		size_t height = 1;
+
+		for (size_t column = 0; column < column_count; column++)
+		{
+			oolong_grid_cell_t* cell = &grid->cells[row * column_count + column];
+			size_t cell_height = 0;
+
+			if (cell->element != NULL)
+				cell_height = oolong_element_get_height(cell->element, grid->column_widths[column]);
+			else if (cell->view != NULL && cell->view->elements != NULL)
+				cell_height = oolong_stack_view_get_height(cell->view, grid->column_widths[column]);
+
+			height = cell_height > height ? cell_height : height;
+		}
+
+		grid->row_heights[row] = height;
+	}
+}
+
+/*
+ * Puts one line of a cell, exactly as wide as its column.
+ */
+static oolong_error_t compose_cell_line(oolong_grid_view_t* grid, size_t row, size_t column, size_t line)
+{
+	oolong_grid_cell_t* cell = &grid->cells[row * grid->options.column_count + column];
+	unsigned int width = grid->column_widths[column];
+
+	if (cell->element != NULL)
+		return oolong_element_compose_line(cell->element, width, line);
+
+	if (cell->view != NULL && cell->view->elements != NULL)
+		return oolong_stack_view_compose_line(cell->view, width, &grid->cursors[column]);
+
+	return oolong_frame_fill(L' ', width);
+}
+
+static oolong_error_t compose(oolong_grid_view_t* grid)
+{
+	size_t column_count = grid->options.column_count;
+	oolong_error_t error = oolong_frame_fill(L'\n', grid->options.margin_top);
+
+	for (size_t row = 0; row < grid->options.row_count && error == OOLONG_ERROR_NONE; row++)
+	{
+		memset(grid->cursors, 0, column_count * sizeof *grid->cursors);
+
+		for (size_t line = 0; line < grid->row_heights[row] && error == OOLONG_ERROR_NONE; line++)
+		{
+			error = oolong_frame_fill(L' ', grid->options.margin_sides);
+
+			for (size_t column = 0; column < column_count && error == OOLONG_ERROR_NONE; column++)
+			{
+				if (column > 0)
+					error = oolong_frame_fill(L' ', grid->options.column_gap);
+
+				if (error == OOLONG_ERROR_NONE)
+					error = compose_cell_line(grid, row, column, line);
+			}
+
+			if (error == OOLONG_ERROR_NONE)
+				error = oolong_frame_fill(L'\n', 1);
+		}
+
+		if (row + 1 < grid->options.row_count && error == OOLONG_ERROR_NONE)
+			error = oolong_frame_fill(L'\n', grid->options.row_gap);
+	}
+
+	return error;
+}
+
+oolong_error_t oolong_grid_view_print(oolong_grid_view_t* grid, file_t* file)
+{
+	if (grid == NULL || file == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (oolong_frame_begin() == NULL)
+		return oolong_error_get_last().error;
+
+	oolong_error_t error = render(grid);
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_RENDER);
+
+	unsigned int columns;
+	oolong_get_screen_dimensions(&columns, NULL);
+
+	unsigned int gaps = grid->options.column_gap * (grid->options.column_count - 1);
+	unsigned int reserved = 2 * grid->options.margin_sides + gaps;
+	unsigned int available = columns > reserved ? columns - reserved : 0;
+
+	/* Column widths only change with the screen's width or a column's natural width. */
+	if (measure(grid) || !grid->laid_out || grid->laid_out_columns != columns)
+	{
+		lay_out_columns(grid, available);
+		grid->laid_out_columns = columns;
+		grid->laid_out = true;
+	}
+
+	lay_out_rows(grid);
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_LAYOUT);
+
+	if ((error = compose(grid)) != OOLONG_ERROR_NONE)
+		return error;
+
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_COMPOSE);
+	return grid->options.diff_rows ? oolong_frame_present_rows(file) : oolong_frame_present(file);
+}
@@ -0,0 +1,101 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_GRID_VIEW_H
+#define OOLONG_GRID_VIEW_H
+
+#include "element.h"
+#include "stack_view.h"
+
+/*
+ * How the width of a grid's column is decided. Fixed and auto columns are
+ * sized first, fractional columns then share whatever is left of the screen in
+ * proportion to their sizes.
+ */
+enum oolong_grid_sizing_e
+{
+	OOLONG_GRID_SIZE_AUTO,		/* As wide as the widest cell in the column. */
+	OOLONG_GRID_SIZE_FIXED,		/* Exactly 'size' columns wide. */
+	OOLONG_GRID_SIZE_FRACTION	/* A share of the remaining columns weighted by 'size'. */
+};
+
+typedef enum oolong_grid_sizing_e oolong_grid_sizing_t;
+typedef struct oolong_grid_column_s oolong_grid_column_t;
+typedef struct oolong_grid_cell_s oolong_grid_cell_t;
+typedef struct oolong_grid_view_s oolong_grid_view_t;
+typedef struct oolong_grid_view_options_s oolong_grid_view_options_t;
+
+struct oolong_grid_column_s
+{
+	oolong_grid_sizing_t sizing;	/* How the column's width is decided. */
+	unsigned int size;				/* Width of a fixed column or weight of a fractional one, unused for auto columns. */
+};
+
+/*
+ * A cell of a grid holds either a single element or a stack view, which is laid
+ * out within the cell as described for oolong_stack_view_compose_line(), or
+ * neither when it is empty.
+ */
+struct oolong_grid_cell_s
+{
+	oolong_element_t* element;
+	oolong_stack_view_t* view;
+};
+
+struct oolong_grid_view_options_s
+{
+	oolong_grid_column_t* columns;	/* Sizing of each column, 'column_count' long. */
+	size_t column_count;			/* Number of columns, at least one. */
+	size_t row_count;				/* Number of rows, at least one. A horizontal stack is a grid of one row. */
+	unsigned int margin_top;		/* Number of newlines from top of terminal to the first row. */
+	unsigned int margin_sides;		/* Number of spaces either side of the grid. */
+	unsigned int column_gap;		/* Number of spaces between columns. */
+	unsigned int row_gap;			/* Number of newlines between rows. */
+	bool diff_rows;					/* Write only the lines changed since the last print, see oolong_frame_present_rows(). */
+};
+
+/*
+ * Creates a grid view with the given options and all of its cells empty. The
+ * column sizing is copied.
+ */
+oolong_grid_view_t* oolong_grid_view_create(oolong_grid_view_options_t* options);
+
+/*
+ * Destroys the grid view, the elements and stack views in its cells are left
+ * as they are.
+ */
+oolong_error_t oolong_grid_view_destroy(oolong_grid_view_t* grid);
+
+/*
+ * Puts an element or stack view in a cell of the grid, replacing whatever was
+ * there. Only the cell's column and row are laid out again.
+ */
+oolong_error_t oolong_grid_view_set_cell(oolong_grid_view_t* grid, size_t column, size_t row, oolong_grid_cell_t cell);
+
+/*
+ * Gets the width a column was last laid out with, 0 if the grid has not been
+ * printed.
+ */
+unsigned int oolong_grid_view_get_column_width(oolong_grid_view_t* grid, size_t column);
+
+/*
+ * Gets the number of cells whose width was measured again by the last print.
+ * Cells are only measured when first set or when an element in them was
+ * rendered again rather than reused, so this is 0 for a grid that has not
+ * changed since it was last printed.
+ */
+size_t oolong_grid_view_get_cells_measured(oolong_grid_view_t* grid);
+
+/*
+ * Prints the grid to the given file as a frame, in the same phases as a stack
+ * view. Every element is rendered to its string, the column widths are worked
+ * out again only if the screen's width or a changed cell's width requires it,
+ * and each row is composed a line at a time into the frame's output. Elements
+ * too wide for their column are word wrapped, a row being as tall as its
+ * tallest cell.
+ */
+oolong_error_t oolong_grid_view_print(oolong_grid_view_t* grid, file_t* file);
+
+#endif // OOLONG_GRID_VIEW_H
@@ -4,8 +4,12 @@
  */
 
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include <termios.h>
+#include "latency.h"
 #include "keyboard.h"
 
 /* Size of the longest escape sequence oolong will accept. */
@@ -18,6 +22,16 @@
 #define CONTROL_HOME 72
 #define CONTROL_END 70
 
+/* 
+ * Recordings start with this magic followed by a version byte, then a record
+ * for every read as the microseconds since the previous read, the number of
+ * bytes read, and the bytes themselves. Both numbers are unsigned LEB128
+ * varints so that a typical keystroke record is only 3 to 5 bytes.
+ */
+#define RECORDING_MAGIC "OOLONGIN"
+#define RECORDING_MAGIC_LENGTH 8
+#define RECORDING_VERSION 1
+
 typedef struct termios terminal_attributes_t;
 
 static size_t buffered_keys_index = 0;
@@ -25,6 +39,110 @@ static size_t buffered_keys_length = 0;
 static oolong_key_t* buffered_keys = NULL;
 static terminal_attributes_t original_terminal_state;
 
+static FILE* record_file = NULL;
+static uint64_t record_previous_time;
+
+static FILE* replay_file = NULL;
+static oolong_replay_speed_t replay_speed;
+static uint64_t replay_start_time;
+static uint64_t replay_offset;
+
+static uint64_t get_microseconds(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000 + time.tv_nsec / 1000;
+}
+
+static void write_varint(uint64_t value, FILE* file)
+{
+    while (value >= 0x80)
+    {
+        fputc((value & 0x7F) | 0x80, file);
+        value >>= 7;
+    }
+
+    fputc(value, file);
+}
+
+static bool read_varint(uint64_t* value, FILE* file)
+{
+    *value = 0;
+
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+        int byte = fgetc(file);
+
+        if (byte == EOF)
+            return false;
+
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+/*
+ * Gets the next recorded read, waiting until it is due when replaying at the
+ * recorded speed. Returns -1 once the recording ends, which also ends the
+ * replay.
+ */
+static ssize_t read_replayed(char* in)
+{
+    uint64_t delay;
+    uint64_t length;
+
+    if (!read_varint(&delay, replay_file) || !read_varint(&length, replay_file) || length == 0 || length > READ_SIZE || fread(in, 1, length, replay_file) != length)
+    {
+        replay_file = NULL;
+        return -1;
+    }
+
+    replay_offset += delay;
+
+    if (replay_speed == OOLONG_REPLAY_RECORDED_SPEED)
+    {
+        uint64_t now = get_microseconds();
+        uint64_t due = replay_start_time + replay_offset;
+
+        if (due > now)
+            nanosleep(&(struct timespec){ .tv_sec = (due - now) / 1000000, .tv_nsec = (due - now) % 1000000 * 1000 }, NULL);
+    }
+
+    return length;
+}
+
+/*
+ * Reads raw input for a single key, from a replay while one is running and
+ * otherwise from stdin, recording what stdin gave if a recording is running.
+ */
+static ssize_t read_input(char* in)
+{
+    if (replay_file != NULL)
+    {
+        ssize_t replayed_size = read_replayed(in);
+
+        if (replayed_size > 0)
+            return replayed_size;
+    }
+
+    ssize_t in_size = read(STDIN_FILENO, in, READ_SIZE);
+
+    if (in_size > 0 && record_file != NULL)
+    {
+        uint64_t now = get_microseconds();
+        write_varint(now - record_previous_time, record_file);
+        write_varint(in_size, record_file);
+        fwrite(in, 1, in_size, record_file);
+        record_previous_time = now;
+    }
+
+    return in_size;
+}
+
 static key_t interpret_escape_sequence(char* in, size_t in_size)
 {
     if (in_size < 3 || in[0] != KEY_ESCAPE || in[1] != KEY_OPEN_BRACKET)
@@ -88,11 +206,12 @@ oolong_key_t oolong_keyboard_get_key(void)
     if (buffered_keys_index < buffered_keys_length)
     {
         buffered_keys_index++;
+        oolong_latency_mark_input();
         return buffered_keys[buffered_keys_index - 1];
     }
     
     char in[READ_SIZE];
-    ssize_t in_size = read(STDIN_FILENO, in, READ_SIZE);
+    ssize_t in_size = read_input(in);
 
     if (in_size < 0)
     {
@@ -100,6 +219,8 @@ oolong_key_t oolong_keyboard_get_key(void)
         return KEY_ERROR;
     }
 
+    oolong_latency_mark_input();
+
     if (in_size == 1)
         return (key_t)in[0];
 
@@ -123,8 +244,60 @@ oolong_error_t oolong_keyboard_buffer_keys(oolong_key_t* keys, size_t keys_lengt
     if (keys == NULL || keys_length < 1)
         return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
 
+    buffered_keys_index = 0;
     buffered_keys_length = keys_length;
     buffered_keys = keys;
     return OOLONG_ERROR_NONE;
 }
 
+oolong_error_t oolong_keyboard_record_start(FILE* file)
+{
+    if (file == NULL || record_file != NULL)
+        return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+    fwrite(RECORDING_MAGIC, 1, RECORDING_MAGIC_LENGTH, file);
+    fputc(RECORDING_VERSION, file);
+
+    if (ferror(file))
+        return oolong_error_record(OOLONG_ERROR_FAILED_IO_WRITE);
+
+    record_file = file;
+    record_previous_time = get_microseconds();
+    return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_keyboard_record_stop(void)
+{
+    if (record_file == NULL)
+        return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+    bool failed = fflush(record_file) != 0 || ferror(record_file);
+    record_file = NULL;
+
+    if (failed)
+        return oolong_error_record(OOLONG_ERROR_FAILED_IO_WRITE);
+
+    return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_keyboard_replay_start(FILE* file, oolong_replay_speed_t speed)
+{
+    if (file == NULL)
+        return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+    char magic[RECORDING_MAGIC_LENGTH];
+
+    if (fread(magic, 1, RECORDING_MAGIC_LENGTH, file) != RECORDING_MAGIC_LENGTH || memcmp(magic, RECORDING_MAGIC, RECORDING_MAGIC_LENGTH) != 0 || fgetc(file) != RECORDING_VERSION)
+        return oolong_error_record(OOLONG_ERROR_FAILED_IO_READ);
+
+    replay_file = file;
+    replay_speed = speed;
+    replay_start_time = get_microseconds();
+    replay_offset = 0;
+    return OOLONG_ERROR_NONE;
+}
+
+bool oolong_keyboard_is_replaying(void)
+{
+    return replay_file != NULL;
+}
@@ -6,6 +6,7 @@
 #ifndef OOLONG_KEYBOARD_H
 #define OOLONG_KEYBOARD_H
 
+#include <stdio.h>
 #include <limits.h>
 #include "error.h"
 
@@ -121,7 +122,14 @@ enum oolong_key_e
     KEY_STRING        = -7,   /* More than one key was recieved, probably from the clipboard. */
 };
 
+enum oolong_replay_speed_e
+{
+    OOLONG_REPLAY_RECORDED_SPEED,   /* Replay input with the timing it was recorded with. */
+    OOLONG_REPLAY_FAST              /* Replay input as fast as it is asked for. */
+};
+
 typedef enum oolong_key_e oolong_key_t;
+typedef enum oolong_replay_speed_e oolong_replay_speed_t;
 
 /*
  * Disables canonical terminal input, causing stdin to not wait for a newline
@@ -138,7 +146,8 @@ oolong_error_t oolong_restore_canonical_input(void);
  * Gets a single keypress, canonical input should be disabled. Returns
  * KEY_ERROR on error and KEY_STRING when more that one byte was provided that
  * was not avalid escape sequence, this probably means either a wide character
- * was entered or text was pasted.
+ * was entered or text was pasted. The time of each key is marked for the
+ * input latency histogram in latency.h.
  */
 oolong_key_t oolong_keyboard_get_key(void);
 
@@ -148,5 +157,31 @@ oolong_key_t oolong_keyboard_get_key(void);
  */
 oolong_error_t oolong_keyboard_buffer_keys(oolong_key_t* keys, size_t keys_length);
 
+/*
+ * Starts recording the raw bytes oolong_keyboard_get_key() reads from stdin,
+ * and when they were read, to the given file in a compact binary format. The
+ * file is not closed by oolong.
+ */
+oolong_error_t oolong_keyboard_record_start(FILE* file);
+
+/*
+ * Stops recording and flushes the recording's file.
+ */
+oolong_error_t oolong_keyboard_record_stop(void);
+
+/*
+ * Starts replaying a recording made with oolong_keyboard_record_start(), from
+ * a file opened for reading at its start. Replayed bytes are decoded exactly
+ * as the recorded ones were, as oolong_keyboard_get_key() reads the recording
+ * instead of stdin until it ends, then goes back to reading stdin. Keys given
+ * to oolong_keyboard_buffer_keys() are still returned first.
+ */
+oolong_error_t oolong_keyboard_replay_start(FILE* file, oolong_replay_speed_t speed);
+
+/*
+ * Checks whether a replay is still running.
+ */
+bool oolong_keyboard_is_replaying(void);
+
 #endif // OOLONG_KEYBOARD_H
 
@@ -3,14 +3,34 @@
  * See LICENSE file in repository root for complete license text.
  */
 
+#include "memory.h"
 #include "label.h"
 
 struct oolong_label_s
 {
 	oolong_element_t element_data;
+	wchar_t inline_string[OOLONG_ELEMENT_INLINE_STRING_LENGTH + 1];
 };
 
+/*
+ * Frees what the label holds outside of its own memory and arena.
+ */
+static void release(void* object)
+{
+	oolong_label_t* label = object;
+
+	if (label->element_data.style_normal != NULL)
+		oolong_style_set_destroy(label->element_data.style_normal);
+
+	oolong_element_destroy_caches(&label->element_data);
+}
+
 oolong_label_t* oolong_label_create(oolong_label_options_t* options)
+{
+	return oolong_label_create_in(NULL, options);
+}
+
+oolong_label_t* oolong_label_create_in(oolong_arena_t* arena, oolong_label_options_t* options)
 {
 	if (options == NULL)
 	{
@@ -18,7 +38,7 @@ oolong_label_t* oolong_label_create(oolong_label_options_t* options)
 		return NULL;
 	}
 
-	oolong_label_t* label = malloc(sizeof(oolong_label_t));
+	oolong_label_t* label = arena == NULL ? oolong_memory_allocate(sizeof *label) : oolong_arena_allocate(arena, sizeof *label);
 
 	if (label == NULL)
 	{
@@ -33,11 +53,22 @@ oolong_label_t* oolong_label_create(oolong_label_options_t* options)
 	label->element_data.padding 			= options->padding;
 	label->element_data.width 				= options->width;
 	label->element_data.style_normal 		= options->style;
-	label->element_data.style_selected 		= NULL;
-	label->element_data.style_active		= NULL;
-	label->element_data.style_disabled 		= NULL;
 	label->element_data.content 			= options->content;
 	label->element_data.string 				= NULL;
+	label->element_data.inline_string	= label->inline_string;
+	label->element_data.string_capacity		= 0;
+	label->element_data.measured_content	= NULL;
+	label->element_data.sized_content		= NULL;
+	label->element_data.content_length		= 0;
+	label->element_data.string_length		= 0;
+	label->element_data.cold				= NULL;
+	label->element_data.arena				= arena;
+
+	if (arena != NULL && oolong_arena_track(arena, label, release) != OOLONG_ERROR_NONE)
+	{
+		oolong_arena_free(arena, label, sizeof *label);
+		return NULL;
+	}
 
 	return label;
 }
@@ -47,9 +78,19 @@ oolong_error_t oolong_label_destroy(oolong_label_t* label)
 	if (label == NULL)
 		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
 
-	oolong_style_set_destroy(label->element_data.style_normal);
-	free(label->element_data.string);
-	free(label);
+	oolong_arena_t* arena = label->element_data.arena;
+
+	release(label);
+	oolong_element_free_string(&label->element_data);
+
+	if (arena == NULL)
+	{
+		oolong_memory_free(label);
+		return OOLONG_ERROR_NONE;
+	}
+
+	oolong_arena_untrack(arena, label);
+	oolong_arena_free(arena, label, sizeof *label);
 	return OOLONG_ERROR_NONE;
 }
 
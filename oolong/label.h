@@ -30,6 +30,13 @@ struct oolong_label_options_s
  */
 oolong_label_t* oolong_label_create(oolong_label_options_t* options);
 
+/*
+ * Creates a label as oolong_label_create() does but keeps it and its rendered string
+ * in the given arena, or on the heap if the arena is NULL. The label may still be
+ * destroyed on its own, otherwise destroying the arena destroys it.
+ */
+oolong_label_t* oolong_label_create_in(oolong_arena_t* arena, oolong_label_options_t* options);
+
 /*
  * Frees all memory used by the label. This will not free the content member
  * given with the options struct while creating the label.
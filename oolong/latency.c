@@ -0,0 +1,135 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <time.h>
+#include <stdatomic.h>
+#include "latency.h"
+
+/* log2 of OOLONG_LATENCY_SUB_BUCKETS. */
+#define SUB_BUCKET_BITS 4
+
+/* 
+ * Input is marked from whichever thread reads the keyboard while frames may be
+ * presented from another, 0 meaning no input is waiting.
+ */
+static atomic_uint_fast64_t pending_input_time = 0;
+static atomic_uint_fast64_t counts[OOLONG_LATENCY_BUCKETS];
+static atomic_uint_fast64_t total_count = 0;
+
+static uint64_t get_time(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+static size_t bucket_index(uint64_t value)
+{
+	if (value < OOLONG_LATENCY_SUB_BUCKETS)
+		return value;
+
+	unsigned int exponent = 63 - __builtin_clzll(value);
+	size_t sub_bucket = (value >> (exponent - SUB_BUCKET_BITS)) & (OOLONG_LATENCY_SUB_BUCKETS - 1);
+	return (exponent - SUB_BUCKET_BITS + 1) * OOLONG_LATENCY_SUB_BUCKETS + sub_bucket;
+}
+
+static uint64_t bucket_highest_value(size_t index)
+{
+	if (index < OOLONG_LATENCY_SUB_BUCKETS)
+		return index;
+
+	unsigned int shift = index / OOLONG_LATENCY_SUB_BUCKETS - 1;
+	uint64_t lowest = (uint64_t)(OOLONG_LATENCY_SUB_BUCKETS + index % OOLONG_LATENCY_SUB_BUCKETS) << shift;
+	return lowest + ((uint64_t)1 << shift) - 1;
+}
+
+void oolong_latency_mark_input(void)
+{
+	uint_fast64_t expected = 0;
+	atomic_compare_exchange_strong(&pending_input_time, &expected, get_time());
+}
+
+uint64_t oolong_latency_mark_presented(void)
+{
+	uint64_t input_time = atomic_exchange(&pending_input_time, 0);
+
+	if (input_time == 0)
+		return 0;
+
+	uint64_t latency = get_time() - input_time;
+	oolong_latency_record(latency);
+	return latency;
+}
+
+oolong_error_t oolong_latency_record(uint64_t nanoseconds)
+{
+	atomic_fetch_add_explicit(&counts[bucket_index(nanoseconds)], 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&total_count, 1, memory_order_relaxed);
+	return OOLONG_ERROR_NONE;
+}
+
+uint64_t oolong_latency_get_count(void)
+{
+	return atomic_load_explicit(&total_count, memory_order_relaxed);
+}
+
+uint64_t oolong_latency_get_percentile(double percentile)
+{
+	uint64_t count = oolong_latency_get_count();
+
+	if (count == 0)
+		return 0;
+
+	/* The rank of the latency asked for, at least the first. */
+	uint64_t rank = (uint64_t)(percentile / 100.0 * count + 0.5);
+	rank = rank < 1 ? 1 : rank;
+	uint64_t running_count = 0;
+
+	for (size_t index = 0; index < OOLONG_LATENCY_BUCKETS; index++)
+	{
+		running_count += atomic_load_explicit(&counts[index], memory_order_relaxed);
+
+		if (running_count >= rank)
+			return bucket_highest_value(index);
+	}
+
+	return bucket_highest_value(OOLONG_LATENCY_BUCKETS - 1);
+}
+
+oolong_error_t oolong_latency_dump(FILE* file)
+{
+	if (file == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	uint64_t count = oolong_latency_get_count();
+	uint64_t running_count = 0;
+
+	for (size_t index = 0; index < OOLONG_LATENCY_BUCKETS; index++)
+	{
+		uint64_t bucket_count = atomic_load_explicit(&counts[index], memory_order_relaxed);
+
+		if (bucket_count == 0)
+			continue;
+
+		running_count += bucket_count;
+		fprintf(file, "%llu %f %llu\n", (unsigned long long)bucket_highest_value(index), 100.0 * running_count / count, (unsigned long long)running_count);
+	}
+
+	if (ferror(file))
+		return oolong_error_record(OOLONG_ERROR_FAILED_IO_WRITE);
+
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_latency_reset(void)
+{
+	atomic_store(&pending_input_time, 0);
+
+	for (size_t index = 0; index < OOLONG_LATENCY_BUCKETS; index++)
+		atomic_store_explicit(&counts[index], 0, memory_order_relaxed);
+
+	atomic_store_explicit(&total_count, 0, memory_order_relaxed);
+	return OOLONG_ERROR_NONE;
+}
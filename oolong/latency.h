@@ -0,0 +1,69 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_LATENCY_H
+#define OOLONG_LATENCY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "error.h"
+
+/* 
+ * Latencies are counted in buckets that double in size with every power of
+ * two, each split into this many equal sub-buckets. Values below it are kept
+ * exactly, larger ones to within 1/16th, about 6%, of their true value.
+ */
+#define OOLONG_LATENCY_SUB_BUCKETS 16
+
+#define OOLONG_LATENCY_BUCKETS ((64 - 3) * OOLONG_LATENCY_SUB_BUCKETS)
+
+/*
+ * Marks that input has arrived, called by oolong_keyboard_get_key() for every
+ * key it returns. Only the earliest input since the last presented frame is
+ * kept, so a burst of keys counts from its first key.
+ */
+void oolong_latency_mark_input(void);
+
+/*
+ * Marks that a frame finished being written, called at the end of
+ * oolong_frame_present(). If input arrived since the previous frame, the time
+ * from that input until now is recorded in the input latency histogram and
+ * returned in nanoseconds, otherwise 0 is returned.
+ */
+uint64_t oolong_latency_mark_presented(void);
+
+/*
+ * Records a latency, in nanoseconds, into the input latency histogram. This is
+ * done by oolong_latency_mark_presented() but may be used for latencies that
+ * are measured elsewhere.
+ */
+oolong_error_t oolong_latency_record(uint64_t nanoseconds);
+
+/*
+ * Gets the number of latencies recorded.
+ */
+uint64_t oolong_latency_get_count(void);
+
+/*
+ * Gets the latency, in nanoseconds, that the given percentage of recorded
+ * latencies are less than or equal to, as the highest value of the bucket it
+ * falls into. A percentile of 50 gives the median and 100 the maximum. Returns
+ * 0 if nothing was recorded.
+ */
+uint64_t oolong_latency_get_percentile(double percentile);
+
+/*
+ * Writes every non-empty bucket of the histogram to the file, one per line as
+ * the bucket's highest value in nanoseconds, the percentile of latencies at or
+ * below it, and the running count, each separated by a space.
+ */
+oolong_error_t oolong_latency_dump(FILE* file);
+
+/*
+ * Forgets every recorded latency and any input waiting on a frame.
+ */
+oolong_error_t oolong_latency_reset(void);
+
+#endif // OOLONG_LATENCY_H
@@ -0,0 +1,1066 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stdint.h>
+#include <wchar.h>
+#include <string.h>
+#include "memory.h"
+#include "screen.h"
+#include "frame.h"
+#include "layout.h"
+
+/* Most separate damaged areas kept before the closest ones are merged. */
+#define MAX_DAMAGE 16
+
+/*
+ * An area of the screen that must be drawn again. Areas a node has moved out of
+ * are erased first, areas only covered by a changed element are overwritten by
+ * composing it.
+ */
+struct damage_s
+{
+	oolong_layout_box_t box;
+	bool erase;
+};
+
+struct damage_set_s
+{
+	struct damage_s* areas;		/* MAX_DAMAGE long, allocated when first needed. */
+	size_t count;
+	bool everything;			/* Set when damage could not be kept, so everything must be drawn again. */
+};
+
+struct oolong_layout_node_s
+{
+	oolong_layout_node_options_t options;
+	oolong_layout_node_t* parent;
+	oolong_layout_node_t** children;
+	size_t child_count;
+	size_t child_capacity;
+	bool dirty;						/* Set when the node must be measured and arranged again. */
+	bool measured;					/* Set once the node has been measured. */
+	bool arranged;					/* Set once the node has been arranged. */
+	unsigned int measured_columns;	/* Columns available to the node when it was last measured. */
+	unsigned int width;				/* Columns the node would like, from its last measurement. */
+	unsigned int height;			/* Rows the node would like, from its last measurement. */
+	unsigned int content_height;	/* Rows the node's content would take without a most rows limit. */
+	unsigned int scroll;			/* Rows a node with a most rows limit is scrolled down its content by. */
+	oolong_layout_box_t box;		/* Box the node was last arranged in. */
+	oolong_layout_box_t clip;		/* Part of the screen the node may be drawn in, from the panes above it. */
+	unsigned int shift;				/* Rows the node is moved up the screen by the scrolling of panes above it. */
+	oolong_layout_box_t visible;	/* Part of the screen the node is drawn in, after moving and clipping. */
+	size_t nodes_measured;			/* Nodes measured by the last update, only kept on the root. */
+	struct damage_set_s damage;		/* Damage since the last print, only kept on the root. */
+	bool printed;					/* Set once the tree has been printed, only kept on the root. */
+	unsigned int printed_columns;	/* Screen columns when the tree was last printed. */
+	unsigned int printed_rows;		/* Screen rows when the tree was last printed. */
+};
+
+static unsigned int maximum(unsigned int a, unsigned int b)
+{
+	return a > b ? a : b;
+}
+
+static unsigned int minimum(unsigned int a, unsigned int b)
+{
+	return a < b ? a : b;
+}
+
+/*
+ * Subtracts without going below 0.
+ */
+static unsigned int less(unsigned int a, unsigned int b)
+{
+	return a > b ? a - b : 0;
+}
+
+static size_t get_area(oolong_layout_box_t box)
+{
+	return (size_t)box.width * box.height;
+}
+
+/*
+ * Gets the smallest box covering both boxes.
+ */
+static oolong_layout_box_t get_union(oolong_layout_box_t a, oolong_layout_box_t b)
+{
+	unsigned int column = minimum(a.column, b.column);
+	unsigned int row = minimum(a.row, b.row);
+
+	return (oolong_layout_box_t)
+	{
+		.column = column,
+		.row = row,
+		.width = maximum(a.column + a.width, b.column + b.width) - column,
+		.height = maximum(a.row + a.height, b.row + b.height) - row
+	};
+}
+
+static bool intersects(oolong_layout_box_t a, oolong_layout_box_t b)
+{
+	return a.column < b.column + b.width && b.column < a.column + a.width && a.row < b.row + b.height && b.row < a.row + a.height;
+}
+
+/*
+ * Gets the box covered by both boxes, which has no width or height if they do
+ * not intersect.
+ */
+static oolong_layout_box_t get_intersection(oolong_layout_box_t a, oolong_layout_box_t b)
+{
+	if (!intersects(a, b))
+		return (oolong_layout_box_t){ 0 };
+
+	unsigned int column = maximum(a.column, b.column);
+	unsigned int row = maximum(a.row, b.row);
+
+	return (oolong_layout_box_t)
+	{
+		.column = column,
+		.row = row,
+		.width = minimum(a.column + a.width, b.column + b.width) - column,
+		.height = minimum(a.row + a.height, b.row + b.height) - row
+	};
+}
+
+static oolong_layout_node_t* get_root(oolong_layout_node_t* node)
+{
+	while (node->parent != NULL)
+		node = node->parent;
+
+	return node;
+}
+
+/*
+ * Records an area of the screen as damaged. Areas are merged
+ * whenever covering both with one box costs no more cells than the two did
+ * separately, which takes in areas that overlap, contain one another, or sit
+ * side by side. Once MAX_DAMAGE areas are kept any more are merged with
+ * whichever area grows the least.
+ */
+static void add_damage(struct damage_set_s* set, oolong_layout_box_t box, bool erase)
+{
+	if (box.width == 0 || box.height == 0)
+		return;
+
+	if (set->areas == NULL && (set->areas = oolong_memory_allocate(MAX_DAMAGE * sizeof *set->areas)) == NULL)
+	{
+		set->everything = true;
+		return;
+	}
+
+	size_t index = 0;
+
+	while (index < set->count)
+	{
+		oolong_layout_box_t merged = get_union(set->areas[index].box, box);
+
+		if (get_area(merged) > get_area(set->areas[index].box) + get_area(box))
+		{
+			index++;
+			continue;
+		}
+
+		/* The merged area may now reach others, so it is checked against every area again. */
+		erase |= set->areas[index].erase;
+		box = merged;
+		set->areas[index] = set->areas[--set->count];
+		index = 0;
+	}
+
+	if (set->count < MAX_DAMAGE)
+	{
+		set->areas[set->count++] = (struct damage_s){ .box = box, .erase = erase };
+		return;
+	}
+
+	size_t closest = 0;
+	size_t closest_growth = SIZE_MAX;
+
+	for (index = 0; index < set->count; index++)
+	{
+		size_t growth = get_area(get_union(set->areas[index].box, box)) - get_area(set->areas[index].box);
+
+		if (growth < closest_growth)
+		{
+			closest = index;
+			closest_growth = growth;
+		}
+	}
+
+	set->areas[closest].box = get_union(set->areas[closest].box, box);
+	set->areas[closest].erase |= erase;
+}
+
+oolong_layout_node_t* oolong_layout_node_create(oolong_layout_node_options_t* options)
+{
+	if (options == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return NULL;
+	}
+
+	oolong_layout_node_t* node = oolong_memory_allocate_zeroed(1, sizeof *node);
+
+	if (node == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+		return NULL;
+	}
+
+	node->options = *options;
+	node->dirty = true;
+	return node;
+}
+
+oolong_error_t oolong_layout_node_destroy(oolong_layout_node_t* node)
+{
+	if (node == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	oolong_layout_node_t* parent = node->parent;
+
+	if (parent != NULL)
+	{
+		/* Whatever the node covered must be erased by the next print. */
+		if (node->arranged)
+			add_damage(&get_root(parent)->damage, node->visible, true);
+
+		for (size_t index = 0; index < parent->child_count; index++)
+		{
+			if (parent->children[index] != node)
+				continue;
+
+			memmove(&parent->children[index], &parent->children[index + 1], (parent->child_count - index - 1) * sizeof *parent->children);
+			parent->child_count--;
+			break;
+		}
+
+		oolong_layout_node_mark_dirty(parent);
+	}
+
+	for (size_t index = 0; index < node->child_count; index++)
+	{
+		/* Children are destroyed without going back through their parent. */
+		node->children[index]->parent = NULL;
+		oolong_layout_node_destroy(node->children[index]);
+	}
+
+	oolong_memory_free(node->children);
+	oolong_memory_free(node->damage.areas);
+	oolong_memory_free(node);
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_layout_node_append(oolong_layout_node_t* parent, oolong_layout_node_t* child)
+{
+	if (parent == NULL || child == NULL || parent->options.element != NULL || child->parent != NULL || parent == child)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (parent->child_count == parent->child_capacity)
+	{
+		size_t capacity = parent->child_capacity < 4 ? 4 : parent->child_capacity * 2;
+		oolong_layout_node_t** children = oolong_memory_reallocate(parent->children, capacity, sizeof *children);
+
+		if (children == NULL)
+			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+		parent->children = children;
+		parent->child_capacity = capacity;
+	}
+
+	parent->children[parent->child_count++] = child;
+	child->parent = parent;
+	return oolong_layout_node_mark_dirty(parent);
+}
+
+oolong_error_t oolong_layout_node_mark_dirty(oolong_layout_node_t* node)
+{
+	if (node == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	/* Every node above a dirty node is already dirty, so marking can stop at the first one. */
+	node->dirty = true;
+
+	for (node = node->parent; node != NULL && !node->dirty; node = node->parent)
+		node->dirty = true;
+
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_layout_node_set_weight(oolong_layout_node_t* node, unsigned int weight)
+{
+	if (node == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	node->options.weight = weight;
+	return oolong_layout_node_mark_dirty(node);
+}
+
+oolong_error_t oolong_layout_node_set_scroll(oolong_layout_node_t* node, unsigned int row)
+{
+	if (node == NULL || node->options.max_height == 0)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	node->scroll = row;
+	return oolong_layout_node_mark_dirty(node);
+}
+
+oolong_layout_box_t oolong_layout_node_get_visible_box(oolong_layout_node_t* node)
+{
+	if (node == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return (oolong_layout_box_t){ 0 };
+	}
+
+	return node->visible;
+}
+
+oolong_layout_box_t oolong_layout_node_get_box(oolong_layout_node_t* node)
+{
+	if (node == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return (oolong_layout_box_t){ 0 };
+	}
+
+	return node->box;
+}
+
+size_t oolong_layout_get_nodes_measured(oolong_layout_node_t* root)
+{
+	if (root == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	return root->nodes_measured;
+}
+
+/*
+ * Measures the width and height the node would like within the given number of
+ * columns, reusing its last measurement if it is not dirty and was measured
+ * within the same number of columns.
+ */
+static void measure(oolong_layout_node_t* node, unsigned int columns, size_t* nodes_measured)
+{
+	if (node->measured && !node->dirty && node->measured_columns == columns)
+		return;
+
+	oolong_layout_node_options_t* options = &node->options;
+	unsigned int width = 0;
+	unsigned int height = 0;
+
+	if (options->element != NULL)
+	{
+		oolong_element_t* element = options->element;
+
+		/* A filling element's width is set from its box, so only its content is measured. */
+		if (options->alignment == OOLONG_ALIGN_WIDTH)
+			width = oolong_element_get_content_width(element) + 2 * element->padding;
+		else if (oolong_element_measure(element) == OOLONG_ERROR_NONE)
+			width = oolong_element_get_string_width(element);
+
+		/* A filling element may not have been rendered at its width yet, so its content decides its height. */
+		width = minimum(maximum(width, options->min_width), columns);
+		height = oolong_element_get_height(element, width);
+	}
+	else
+	{
+		unsigned int inner_columns = less(columns, 2 * options->padding);
+		unsigned int used = 0;
+		unsigned int weights = 0;
+
+		for (size_t index = 0; index < node->child_count; index++)
+		{
+			oolong_layout_node_t* child = node->children[index];
+			unsigned int gap = index > 0 ? options->gap : 0;
+			unsigned int sides = 2 * child->options.margin_sides;
+
+			if (options->direction == OOLONG_LAYOUT_VERTICAL)
+			{
+				measure(child, less(inner_columns, sides), nodes_measured);
+				width = maximum(width, child->width + sides);
+				height += gap + child->options.margin_top + child->height;
+			}
+			else if (child->options.weight > 0)
+			{
+				used += gap + sides;
+				weights += child->options.weight;
+			}
+			else
+			{
+				/* Children across the screen each get whatever the ones before them left. */
+				measure(child, less(inner_columns, used + gap + sides), nodes_measured);
+				used += gap + sides + child->width;
+				height = maximum(height, child->options.margin_top + child->height);
+			}
+		}
+
+		/* Weighted children then share out whatever is left in proportion to their weights. */
+		unsigned int spare = less(inner_columns, used);
+
+		for (size_t index = 0; index < node->child_count && weights > 0; index++)
+		{
+			oolong_layout_node_t* child = node->children[index];
+
+			if (child->options.weight == 0)
+				continue;
+
+			/* The last weighted child takes whatever does not share out evenly. */
+			unsigned int share = child->options.weight == weights ? spare : (unsigned int)((uint64_t)spare * child->options.weight / weights);
+			spare -= share;
+			weights -= child->options.weight;
+
+			measure(child, share, nodes_measured);
+			used += child->width;
+			height = maximum(height, child->options.margin_top + child->height);
+		}
+
+		width = options->direction == OOLONG_LAYOUT_VERTICAL ? width : used;
+		width = minimum(maximum(width + 2 * options->padding, options->min_width), columns);
+	}
+
+	/* A weighted node takes all of its share. */
+	if (options->weight > 0)
+		width = columns;
+
+	node->width = width;
+	node->content_height = maximum(height, options->min_height);
+	node->height = options->max_height > 0 ? minimum(node->content_height, options->max_height) : node->content_height;
+	node->measured_columns = columns;
+	node->measured = true;
+	(*nodes_measured)++;
+}
+
+/*
+ * Arranges the node in the given box and its children within it, skipping any
+ * node that is not dirty and is arranged in the same box, clip, and shift as
+ * before. Boxes are worked out as if no pane were scrolled, the node being
+ * drawn 'shift' rows higher up and only within 'clip', and a node with a most
+ * rows limit clipping its children to where it is drawn. A node drawn in a
+ * different part of the screen damages both parts, which covers everything
+ * below it, so its children are told not to record their own.
+ */
+static void arrange(oolong_layout_node_t* root, oolong_layout_node_t* node, oolong_layout_box_t box, oolong_layout_box_t clip, unsigned int shift, bool damaged)
+{
+	bool moved = !node->arranged || memcmp(&node->box, &box, sizeof box) != 0 || memcmp(&node->clip, &clip, sizeof clip) != 0 || node->shift != shift;
+
+	if (!moved && !node->dirty)
+		return;
+
+	/* Clipping is done where the content would be, before moving it up the screen. */
+	oolong_layout_box_t visible = get_intersection(box, (oolong_layout_box_t){ clip.column, clip.row + shift, clip.width, clip.height });
+	visible.row = visible.height > 0 ? visible.row - shift : 0;
+
+	if (moved && !damaged && (!node->arranged || memcmp(&node->visible, &visible, sizeof visible) != 0))
+	{
+		if (node->arranged)
+			add_damage(&root->damage, node->visible, true);
+
+		add_damage(&root->damage, visible, true);
+		damaged = true;
+	}
+
+	node->box = box;
+	node->clip = clip;
+	node->shift = shift;
+	node->visible = visible;
+	node->arranged = true;
+	node->dirty = false;
+
+	oolong_layout_node_options_t* options = &node->options;
+
+	if (options->element != NULL)
+	{
+		if (options->alignment == OOLONG_ALIGN_WIDTH)
+			options->element->width = box.width;
+
+		return;
+	}
+
+	unsigned int inner_column = box.column + options->padding;
+	unsigned int inner_columns = less(box.width, 2 * options->padding);
+	unsigned int spare = 0;
+	unsigned int fillers = 0;
+
+	/* Spare columns across the screen are shared between the width aligned children. */
+	if (options->direction == OOLONG_LAYOUT_HORIZONTAL)
+	{
+		unsigned int used = 0;
+
+		for (size_t index = 0; index < node->child_count; index++)
+		{
+			oolong_layout_node_t* child = node->children[index];
+			used += (index > 0 ? options->gap : 0) + 2 * child->options.margin_sides + child->width;
+			fillers += child->options.alignment == OOLONG_ALIGN_WIDTH;
+		}
+
+		spare = less(inner_columns, used);
+	}
+
+	unsigned int column = inner_column;
+	unsigned int row = box.row;
+
+	/* A pane's children are clipped to it and moved up by however far it is scrolled. */
+	if (options->max_height > 0)
+	{
+		clip = visible;
+		shift += minimum(node->scroll, less(node->content_height, box.height));
+	}
+
+	for (size_t index = 0; index < node->child_count; index++)
+	{
+		oolong_layout_node_t* child = node->children[index];
+		oolong_layout_node_options_t* child_options = &child->options;
+		oolong_layout_box_t child_box = { .width = child->width, .height = child->height };
+
+		if (options->direction == OOLONG_LAYOUT_VERTICAL)
+		{
+			unsigned int available = less(inner_columns, 2 * child_options->margin_sides);
+			unsigned int offset = 0;
+
+			row += (index > 0 ? options->gap : 0) + child_options->margin_top;
+
+			switch (child_options->alignment)
+			{
+				case (OOLONG_ALIGN_LEFT):	offset = 0;										break;
+				case (OOLONG_ALIGN_CENTER):	offset = less(available, child_box.width) / 2;	break;
+				case (OOLONG_ALIGN_RIGHT):	offset = less(available, child_box.width);		break;
+				case (OOLONG_ALIGN_WIDTH):	child_box.width = available;					break;
+			}
+
+			child_box.column = inner_column + child_options->margin_sides + offset;
+			child_box.row = row;
+			row += child_box.height;
+		}
+		else
+		{
+			column += (index > 0 ? options->gap : 0) + child_options->margin_sides;
+
+			if (child_options->alignment == OOLONG_ALIGN_WIDTH && fillers > 0)
+			{
+				/* The first fillers take any columns that do not share out evenly. */
+				child_box.width += spare / fillers + (spare % fillers > 0 ? 1 : 0);
+				spare -= spare / fillers + (spare % fillers > 0 ? 1 : 0);
+				fillers--;
+			}
+
+			child_box.column = column;
+			child_box.row = row + child_options->margin_top;
+			column += child_box.width + child_options->margin_sides;
+		}
+
+		arrange(root, child, child_box, clip, shift, damaged);
+	}
+}
+
+oolong_error_t oolong_layout_update(oolong_layout_node_t* root, unsigned int columns, unsigned int rows)
+{
+	if (root == NULL || root->parent != NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	oolong_layout_node_options_t* options = &root->options;
+	unsigned int available = less(columns, 2 * options->margin_sides);
+
+	root->nodes_measured = 0;
+	measure(root, available, &root->nodes_measured);
+
+	oolong_layout_box_t box =
+	{
+		.column = options->margin_sides,
+		.row = options->margin_top,
+		.width = options->alignment == OOLONG_ALIGN_WIDTH ? available : root->width,
+		.height = root->height
+	};
+
+	/* Nothing is drawn outside the screen, so the whole tree is clipped to it. */
+	arrange(root, root, box, (oolong_layout_box_t){ .width = columns, .height = rows }, 0, false);
+	return OOLONG_ERROR_NONE;
+}
+
+size_t oolong_layout_get_damage(oolong_layout_node_t* root, oolong_layout_box_t* boxes, size_t length)
+{
+	if (root == NULL || (boxes == NULL && length > 0))
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	for (size_t index = 0; index < root->damage.count && index < length; index++)
+		boxes[index] = root->damage.areas[index].box;
+
+	return root->damage.count;
+}
+
+/*
+ * Renders the element of every leaf below the node, damaging the box of each
+ * leaf whose element was rendered again rather than reused. Changes to an
+ * element's content, state, or style all show up this way.
+ */
+static oolong_error_t render(oolong_layout_node_t* root, oolong_layout_node_t* node, size_t* rendered, size_t* reused)
+{
+	if (node->options.element != NULL)
+	{
+		oolong_error_t error = oolong_element_render_string(node->options.element);
+
+		if (!node->options.element->reused)
+			add_damage(&root->damage, node->visible, false);
+
+		*rendered += !node->options.element->reused;
+		*reused += node->options.element->reused;
+		return error;
+	}
+
+	for (size_t index = 0; index < node->child_count; index++)
+	{
+		oolong_error_t error = render(root, node->children[index], rendered, reused);
+
+		if (error != OOLONG_ERROR_NONE)
+			return error;
+	}
+
+	return OOLONG_ERROR_NONE;
+}
+
+/*
+ * Puts an escape sequence moving the cursor to the given column and row,
+ * counted from 0.
+ */
+static oolong_error_t put_cursor_position(unsigned int column, unsigned int row)
+{
+	wchar_t escape[32];
+	int length = swprintf(escape, sizeof escape / sizeof *escape, L"\x1b[%u;%uH", row + 1, column + 1);
+	wchar_t* destination = oolong_frame_reserve(length);
+
+	if (destination == NULL)
+		return oolong_error_get_last().error;
+
+	wmemcpy(destination, escape, length);
+	return OOLONG_ERROR_NONE;
+}
+
+static bool is_damaged(struct damage_set_s* damage, oolong_layout_box_t box)
+{
+	for (size_t index = 0; index < damage->count; index++)
+		if (intersects(damage->areas[index].box, box))
+			return true;
+
+	return false;
+}
+
+static bool contains(oolong_layout_box_t outer, oolong_layout_box_t inner)
+{
+	return inner.column >= outer.column && inner.row >= outer.row && inner.column + inner.width <= outer.column + outer.width && inner.row + inner.height <= outer.row + outer.height;
+}
+
+/*
+ * What composing part of a frame draws: the damaged areas, leaving out
+ * whatever is hidden by the occluders, the boxes of opaque layers above.
+ */
+struct compose_s
+{
+	struct damage_set_s* damage;
+	oolong_layout_box_t* occluders;
+	size_t occluder_count;
+	unsigned int columns;
+	unsigned int rows;
+	size_t lines_composed;
+	size_t lines_occluded;
+};
+
+static bool is_occluded(struct compose_s* compose, oolong_layout_box_t box)
+{
+	for (size_t index = 0; index < compose->occluder_count; index++)
+		if (contains(compose->occluders[index], box))
+			return true;
+
+	return false;
+}
+
+/*
+ * Fills a span of a row with spaces, leaving out any part of it covered by an
+ * occluder from 'first' on.
+ */
+static oolong_error_t fill_uncovered(struct compose_s* compose, size_t first, unsigned int column, unsigned int row, unsigned int width)
+{
+	if (width == 0)
+		return OOLONG_ERROR_NONE;
+
+	for (size_t index = first; index < compose->occluder_count; index++)
+	{
+		oolong_layout_box_t occluder = compose->occluders[index];
+
+		if (!intersects(occluder, (oolong_layout_box_t){ column, row, width, 1 }))
+			continue;
+
+		/* What is left either side of the occluder may still be covered by another. */
+		unsigned int right = occluder.column + occluder.width;
+		oolong_error_t error = fill_uncovered(compose, index + 1, column, row, less(occluder.column, column));
+
+		if (error == OOLONG_ERROR_NONE && right < column + width)
+			error = fill_uncovered(compose, index + 1, right, row, column + width - right);
+
+		return error;
+	}
+
+	oolong_error_t error = put_cursor_position(column, row);
+
+	if (error == OOLONG_ERROR_NONE)
+		error = oolong_frame_fill(L' ', width);
+
+	return error;
+}
+
+/*
+ * Fills with spaces the parts of the box that are damaged, or only those to be
+ * erased, leaving out anything occluded or past the screen's last column or
+ * row.
+ */
+static oolong_error_t fill_damaged(struct compose_s* compose, oolong_layout_box_t box, bool erased_only)
+{
+	oolong_error_t error = OOLONG_ERROR_NONE;
+
+	for (size_t index = 0; index < compose->damage->count && error == OOLONG_ERROR_NONE; index++)
+	{
+		oolong_layout_box_t area = compose->damage->areas[index].box;
+
+		if ((erased_only && !compose->damage->areas[index].erase) || !intersects(area, box))
+			continue;
+
+		unsigned int column = maximum(area.column, box.column);
+		unsigned int row = maximum(area.row, box.row);
+		unsigned int end = minimum(minimum(area.column + area.width, box.column + box.width), compose->columns);
+		unsigned int bottom = minimum(minimum(area.row + area.height, box.row + box.height), compose->rows);
+
+		for (; row < bottom && column < end && error == OOLONG_ERROR_NONE; row++)
+			error = fill_uncovered(compose, 0, column, row, end - column);
+	}
+
+	return error;
+}
+
+/*
+ * Composes the lines of every leaf below the node that are inside its clip and
+ * on the screen, fall in a damaged area, and are not occluded, skipping any node
+ * where it is drawn is not damaged at all.
+ */
+static oolong_error_t compose_node(struct compose_s* compose, oolong_layout_node_t* node)
+{
+	oolong_error_t error = OOLONG_ERROR_NONE;
+
+	if (!is_damaged(compose->damage, node->visible))
+		return OOLONG_ERROR_NONE;
+
+	if (node->options.element != NULL)
+	{
+		/* The first line drawn is however many of the element's lines are clipped off the top. */
+		unsigned int first = node->visible.row + node->shift - node->box.row;
+
+		for (unsigned int line = 0; line < node->visible.height && error == OOLONG_ERROR_NONE; line++)
+		{
+			oolong_layout_box_t line_box = { node->visible.column, node->visible.row + line, node->visible.width, 1 };
+
+			/* The cursor cannot be moved past the last row, so lines below it would overwrite it. */
+			if (line_box.row >= compose->rows)
+				break;
+
+			if (!is_damaged(compose->damage, line_box))
+				continue;
+
+			if (is_occluded(compose, line_box))
+			{
+				compose->lines_occluded++;
+				continue;
+			}
+
+			error = put_cursor_position(node->box.column, node->visible.row + line);
+
+			if (error == OOLONG_ERROR_NONE)
+				error = oolong_element_compose_line(node->options.element, node->box.width, first + line);
+
+			compose->lines_composed++;
+		}
+
+		return error;
+	}
+
+	for (size_t index = 0; index < node->child_count && error == OOLONG_ERROR_NONE; index++)
+		error = compose_node(compose, node->children[index]);
+
+	return error;
+}
+
+/*
+ * Clears the screen and damages all of it, for when nothing on it can be
+ * relied on.
+ */
+static oolong_error_t damage_screen(struct damage_set_s* damage, unsigned int columns, unsigned int rows)
+{
+	wchar_t* clear = oolong_frame_reserve(4);
+
+	if (clear == NULL)
+		return oolong_error_get_last().error;
+
+	wmemcpy(clear, L"\x1b[2J", 4);
+	damage->count = 0;
+	damage->everything = false;
+	add_damage(damage, (oolong_layout_box_t){ .width = columns, .height = rows }, false);
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_layout_print(oolong_layout_node_t* root, FILE* file)
+{
+	if (root == NULL || file == NULL || root->parent != NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (oolong_frame_begin() == NULL)
+		return oolong_error_get_last().error;
+
+	unsigned int columns, rows;
+	oolong_get_screen_dimensions(&columns, &rows);
+
+	oolong_error_t error = oolong_layout_update(root, columns, rows);
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_LAYOUT);
+
+	size_t rendered = 0;
+	size_t reused = 0;
+
+	if ((error = render(root, root, &rendered, &reused)) != OOLONG_ERROR_NONE)
+		return error;
+
+	oolong_frame_count_elements(rendered, reused);
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_RENDER);
+
+	/* The first print, or one to a resized screen, clears it and draws everything. */
+	if (!root->printed || root->printed_columns != columns || root->printed_rows != rows || root->damage.everything)
+		error = damage_screen(&root->damage, columns, rows);
+
+	struct compose_s compose = { .damage = &root->damage, .columns = columns, .rows = rows };
+	oolong_layout_box_t screen = { .width = columns, .height = rows };
+
+	if (error != OOLONG_ERROR_NONE || (error = fill_damaged(&compose, screen, true)) != OOLONG_ERROR_NONE || (error = compose_node(&compose, root)) != OOLONG_ERROR_NONE)
+		return error;
+
+	root->damage.count = 0;
+	root->printed = !root->damage.everything;
+	root->printed_columns = columns;
+	root->printed_rows = rows;
+
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_COMPOSE);
+	return oolong_frame_present(file);
+}
+
+struct layer_s
+{
+	oolong_layout_node_t* root;
+	bool opaque;
+};
+
+struct oolong_layer_stack_s
+{
+	struct layer_s* layers;				/* Bottom layer first. */
+	size_t layer_count;
+	size_t layer_capacity;
+	oolong_layout_box_t* occluders;		/* Boxes of the opaque layers, bottom first, 'layer_capacity' long. */
+	struct damage_set_s damage;			/* Damage from every layer since the last print. */
+	bool printed;						/* Set once the stack has been printed. */
+	unsigned int printed_columns;		/* Screen columns when the stack was last printed. */
+	unsigned int printed_rows;			/* Screen rows when the stack was last printed. */
+	size_t lines_composed;				/* Leaf lines composed by the last print. */
+	size_t lines_occluded;				/* Damaged leaf lines skipped by the last print for being occluded. */
+};
+
+oolong_layer_stack_t* oolong_layer_stack_create(void)
+{
+	oolong_layer_stack_t* stack = oolong_memory_allocate_zeroed(1, sizeof *stack);
+
+	if (stack == NULL)
+		oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+	return stack;
+}
+
+oolong_error_t oolong_layer_stack_destroy(oolong_layer_stack_t* stack)
+{
+	if (stack == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	oolong_memory_free(stack->layers);
+	oolong_memory_free(stack->occluders);
+	oolong_memory_free(stack->damage.areas);
+	oolong_memory_free(stack);
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_layer_stack_push(oolong_layer_stack_t* stack, oolong_layout_node_t* root, bool opaque)
+{
+	if (stack == NULL || root == NULL || root->parent != NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (stack->layer_count == stack->layer_capacity)
+	{
+		size_t capacity = stack->layer_capacity < 4 ? 4 : stack->layer_capacity * 2;
+		struct layer_s* layers = oolong_memory_reallocate(stack->layers, capacity, sizeof *layers);
+
+		if (layers == NULL)
+			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+		stack->layers = layers;
+		oolong_layout_box_t* occluders = oolong_memory_reallocate(stack->occluders, capacity, sizeof *occluders);
+
+		if (occluders == NULL)
+			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+		stack->occluders = occluders;
+		stack->layer_capacity = capacity;
+	}
+
+	/* A tree already laid out will not damage its box by moving, so it is damaged here. */
+	if (root->arranged)
+		add_damage(&stack->damage, root->visible, true);
+
+	stack->layers[stack->layer_count++] = (struct layer_s){ .root = root, .opaque = opaque };
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_layer_stack_remove(oolong_layer_stack_t* stack, oolong_layout_node_t* root)
+{
+	if (stack == NULL || root == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	for (size_t index = 0; index < stack->layer_count; index++)
+	{
+		if (stack->layers[index].root != root)
+			continue;
+
+		/* Only what the layer covered is drawn again, from the layers that were beneath it. */
+		if (root->arranged)
+			add_damage(&stack->damage, root->visible, true);
+
+		memmove(&stack->layers[index], &stack->layers[index + 1], (stack->layer_count - index - 1) * sizeof *stack->layers);
+		stack->layer_count--;
+		return OOLONG_ERROR_NONE;
+	}
+
+	return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+}
+
+size_t oolong_layer_stack_get_lines_composed(oolong_layer_stack_t* stack)
+{
+	if (stack == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	return stack->lines_composed;
+}
+
+size_t oolong_layer_stack_get_lines_occluded(oolong_layer_stack_t* stack)
+{
+	if (stack == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	return stack->lines_occluded;
+}
+
+oolong_error_t oolong_layer_stack_print(oolong_layer_stack_t* stack, FILE* file)
+{
+	if (stack == NULL || file == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (oolong_frame_begin() == NULL)
+		return oolong_error_get_last().error;
+
+	unsigned int columns, rows;
+	oolong_get_screen_dimensions(&columns, &rows);
+
+	oolong_error_t error = OOLONG_ERROR_NONE;
+
+	for (size_t index = 0; index < stack->layer_count && error == OOLONG_ERROR_NONE; index++)
+		error = oolong_layout_update(stack->layers[index].root, columns, rows);
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_LAYOUT);
+
+	size_t rendered = 0;
+	size_t reused = 0;
+
+	/* Every layer's damage is drawn by every layer, since they share the screen. */
+	for (size_t index = 0; index < stack->layer_count && error == OOLONG_ERROR_NONE; index++)
+	{
+		oolong_layout_node_t* root = stack->layers[index].root;
+		error = render(root, root, &rendered, &reused);
+
+		for (size_t area = 0; area < root->damage.count; area++)
+			add_damage(&stack->damage, root->damage.areas[area].box, root->damage.areas[area].erase);
+
+		stack->damage.everything |= root->damage.everything;
+		root->damage.count = 0;
+		root->damage.everything = false;
+	}
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+
+	oolong_frame_count_elements(rendered, reused);
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_RENDER);
+
+	if (!stack->printed || stack->printed_columns != columns || stack->printed_rows != rows || stack->damage.everything)
+		error = damage_screen(&stack->damage, columns, rows);
+
+	size_t occluder_count = 0;
+
+	for (size_t index = 0; index < stack->layer_count; index++)
+		if (stack->layers[index].opaque)
+			stack->occluders[occluder_count++] = stack->layers[index].root->visible;
+
+	struct compose_s compose = { .damage = &stack->damage, .occluders = stack->occluders, .occluder_count = occluder_count, .columns = columns, .rows = rows };
+	oolong_layout_box_t screen = { .width = columns, .height = rows };
+
+	/* Erasing leaves out whatever opaque layers cover, since they fill their boxes themselves. */
+	if (error == OOLONG_ERROR_NONE)
+		error = fill_damaged(&compose, screen, true);
+
+	/* Layers are drawn from the bottom up, each occluded only by the opaque layers above it. */
+	for (size_t index = 0; index < stack->layer_count && error == OOLONG_ERROR_NONE; index++)
+	{
+		struct layer_s* layer = &stack->layers[index];
+
+		if (layer->opaque)
+		{
+			compose.occluders++;
+			compose.occluder_count--;
+			error = fill_damaged(&compose, layer->root->visible, false);
+		}
+
+		if (error == OOLONG_ERROR_NONE)
+			error = compose_node(&compose, layer->root);
+	}
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+
+	stack->damage.count = 0;
+	stack->printed = !stack->damage.everything;
+	stack->printed_columns = columns;
+	stack->printed_rows = rows;
+	stack->lines_composed = compose.lines_composed;
+	stack->lines_occluded = compose.lines_occluded;
+
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_COMPOSE);
+	return oolong_frame_present(file);
+}
@@ -0,0 +1,200 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_LAYOUT_H
+#define OOLONG_LAYOUT_H
+
+#include <stdio.h>
+#include "element.h"
+
+/*
+ * A layout is a tree of nodes, each laid out in a box on the screen. Leaf nodes
+ * lay out a single element, container nodes lay their children out one after
+ * another down or across the screen.
+ *
+ * Laying out a tree first measures how big each node would like to be within
+ * the width available to it, then arranges nodes into boxes from the root down.
+ * Each node keeps its measurement and box, and both are only worked out again
+ * for nodes marked dirty, which marks every node above them too, or whose
+ * available width or box changed. Updating a large tree after changing one
+ * element therefore costs about as much as the path from that element up to
+ * the root.
+ *
+ * A node with a most rows limit is a pane. Its content is laid out as tall as
+ * it needs to be and clipped to the pane's box, so the lines of elements
+ * outside it are never composed, and the pane can be scrolled down its
+ * content. Panes side by side with weights make a split whose panes are
+ * resized by changing their weights. Since each pane is measured within its
+ * own width and clipped to its own rows, a change inside one pane only damages
+ * that pane.
+ */
+enum oolong_layout_direction_e
+{
+	OOLONG_LAYOUT_VERTICAL,
+	OOLONG_LAYOUT_HORIZONTAL
+};
+
+typedef enum oolong_layout_direction_e oolong_layout_direction_t;
+typedef struct oolong_layout_box_s oolong_layout_box_t;
+typedef struct oolong_layout_node_s oolong_layout_node_t;
+typedef struct oolong_layout_node_options_s oolong_layout_node_options_t;
+typedef struct oolong_layer_stack_s oolong_layer_stack_t;
+
+/*
+ * The columns and rows, counted from 0 at the top left of the screen, that a
+ * node is laid out in, not including its margins.
+ */
+struct oolong_layout_box_s
+{
+	unsigned int column;
+	unsigned int row;
+	unsigned int width;
+	unsigned int height;
+};
+
+struct oolong_layout_node_options_s
+{
+	oolong_element_t* element;				/* Element laid out by a leaf node, NULL for a container. */
+	oolong_layout_direction_t direction;	/* Direction a container lays out its children in. */
+	oolong_alignment_t alignment;			/* Alignment within a vertical parent, width alignment filling it. In a horizontal parent width alignment shares out spare columns. */
+	unsigned int min_width;					/* Fewest columns the node is laid out in. */
+	unsigned int min_height;				/* Fewest rows the node is laid out in. */
+	unsigned int max_height;				/* Most rows the node is laid out in, 0 for no limit. A limited node is a pane, as described above. */
+	unsigned int weight;					/* Share of a horizontal parent's spare columns in proportion to its siblings' weights, 0 to size by content. */
+	unsigned int margin_top;				/* Rows above the node. */
+	unsigned int margin_sides;				/* Columns either side of the node. */
+	unsigned int padding;					/* Columns either side of a container's children, inside its box. */
+	unsigned int gap;						/* Rows or columns between a container's children. */
+};
+
+/*
+ * Creates a layout node with the given options and no children. A leaf node
+ * with width alignment has its element's width set to its box's width, as a
+ * width aligned stack view does, the element keeping its own alignment.
+ */
+oolong_layout_node_t* oolong_layout_node_create(oolong_layout_node_options_t* options);
+
+/*
+ * Destroys the node and every node below it, first removing it from its
+ * parent. Elements are left as they are.
+ */
+oolong_error_t oolong_layout_node_destroy(oolong_layout_node_t* node);
+
+/*
+ * Adds a node without a parent as the last child of a container node.
+ */
+oolong_error_t oolong_layout_node_append(oolong_layout_node_t* parent, oolong_layout_node_t* child);
+
+/*
+ * Marks the node, and every node above it, to be measured and arranged again
+ * by the next update. Must be called after changing a leaf's element in any way
+ * that could change its size, such as setting its content.
+ */
+oolong_error_t oolong_layout_node_mark_dirty(oolong_layout_node_t* node);
+
+/*
+ * Sets the node's weight, resizing it and its weighted siblings.
+ */
+oolong_error_t oolong_layout_node_set_weight(oolong_layout_node_t* node, unsigned int weight);
+
+/*
+ * Scrolls a pane so that the given row of its content is at its top, stopping
+ * once its last row reaches its bottom.
+ */
+oolong_error_t oolong_layout_node_set_scroll(oolong_layout_node_t* node, unsigned int row);
+
+/*
+ * Gets the box the node was laid out in by the last update, as if no pane
+ * were scrolled.
+ */
+oolong_layout_box_t oolong_layout_node_get_box(oolong_layout_node_t* node);
+
+/*
+ * Gets the part of the screen the node was drawn in by the last update, after
+ * the panes above it are scrolled and clipped. It has no width or height if
+ * the node is scrolled out of sight.
+ */
+oolong_layout_box_t oolong_layout_node_get_visible_box(oolong_layout_node_t* node);
+
+/*
+ * Lays the tree out on a screen of the given number of columns and rows, the
+ * root's margins being from the screen's edges. Every node is clipped to the
+ * screen, so the visible box of a node past its edges is cut short or empty.
+ */
+oolong_error_t oolong_layout_update(oolong_layout_node_t* root, unsigned int columns, unsigned int rows);
+
+/*
+ * Gets the number of nodes measured again by the last update of the tree the
+ * given root belongs to.
+ */
+size_t oolong_layout_get_nodes_measured(oolong_layout_node_t* root);
+
+/*
+ * Copies up to 'length' of the areas of the screen damaged since the tree was
+ * last printed into 'boxes', returning how many there are. A node damages the
+ * box it was in and the one it is in whenever it is arranged in a different
+ * box, or removed, and a leaf damages its box whenever its element is rendered
+ * again rather than reused. Damage is merged as it is recorded into a small set
+ * of areas.
+ */
+size_t oolong_layout_get_damage(oolong_layout_node_t* root, oolong_layout_box_t* boxes, size_t length);
+
+/*
+ * Prints the tree to the given file as a frame. The tree is updated for the
+ * screen's width and every leaf's element is rendered, then only the damaged
+ * areas are drawn again: areas nodes have left are erased, and the lines of
+ * each element falling in a damaged area are composed into its box, word
+ * wrapped if the box is narrower than the element, with the cursor moved to the
+ * start of every line. The first print, and any after the screen is resized,
+ * clears the screen and draws everything.
+ */
+oolong_error_t oolong_layout_print(oolong_layout_node_t* root, FILE* file);
+
+/*
+ * A layer stack prints several layout trees over one another on the same
+ * screen, such as a table with a dialog, tooltip, or dropdown over it. Layers
+ * are drawn from the bottom up, each in its own part of the frame, and share
+ * their damage, so whatever changes in one layer is drawn again in every
+ * layer it shows through. An opaque layer fills its root's box with spaces
+ * before drawing its tree, and hides the layers beneath it: their lines that
+ * it covers completely are not composed at all. Removing a layer only draws
+ * again the box it covered.
+ */
+oolong_layer_stack_t* oolong_layer_stack_create(void);
+
+/*
+ * Destroys the layer stack, the trees in it are left as they are.
+ */
+oolong_error_t oolong_layer_stack_destroy(oolong_layer_stack_t* stack);
+
+/*
+ * Puts the tree with the given root on top of the stack.
+ */
+oolong_error_t oolong_layer_stack_push(oolong_layer_stack_t* stack, oolong_layout_node_t* root, bool opaque);
+
+/*
+ * Takes the tree with the given root out of the stack, wherever it is.
+ */
+oolong_error_t oolong_layer_stack_remove(oolong_layer_stack_t* stack, oolong_layout_node_t* root);
+
+/*
+ * Gets the number of element lines composed by the last print of the stack.
+ */
+size_t oolong_layer_stack_get_lines_composed(oolong_layer_stack_t* stack);
+
+/*
+ * Gets the number of damaged element lines the last print of the stack left
+ * out for being hidden by an opaque layer above them.
+ */
+size_t oolong_layer_stack_get_lines_occluded(oolong_layer_stack_t* stack);
+
+/*
+ * Prints every layer of the stack to the given file as one frame, updating and
+ * rendering each tree as oolong_layout_print() does and drawing only the
+ * damaged areas of the screen.
+ */
+oolong_error_t oolong_layer_stack_print(oolong_layer_stack_t* stack, FILE* file);
+
+#endif // OOLONG_LAYOUT_H
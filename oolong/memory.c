@@ -0,0 +1,98 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "memory.h"
+
+static void* default_allocate(void* user, size_t size)
+{
+	(void)user;
+	return malloc(size);
+}
+
+static void* default_reallocate(void* user, void* pointer, size_t size)
+{
+	(void)user;
+	return realloc(pointer, size);
+}
+
+static void default_free(void* user, void* pointer)
+{
+	(void)user;
+	free(pointer);
+}
+
+static const oolong_allocator_t default_allocator =
+{
+	.allocate = default_allocate,
+	.reallocate = default_reallocate,
+	.free = default_free,
+	.user = NULL
+};
+
+static oolong_allocator_t allocator = default_allocator;
+
+/* Relaxed, it is only ever read as a running total. */
+static atomic_size_t allocations = 0;
+
+oolong_error_t oolong_memory_set_allocator(const oolong_allocator_t* new_allocator)
+{
+	if (new_allocator == NULL)
+	{
+		allocator = default_allocator;
+		return OOLONG_ERROR_NONE;
+	}
+
+	if (new_allocator->allocate == NULL || new_allocator->reallocate == NULL || new_allocator->free == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	allocator = *new_allocator;
+	return OOLONG_ERROR_NONE;
+}
+
+void* oolong_memory_allocate(size_t size)
+{
+	atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+	return allocator.allocate(allocator.user, size);
+}
+
+void* oolong_memory_allocate_zeroed(size_t count, size_t size)
+{
+	size_t total;
+
+	if (__builtin_mul_overflow(count, size, &total))
+		return NULL;
+
+	void* pointer = oolong_memory_allocate(total);
+
+	if (pointer != NULL)
+		memset(pointer, 0, total);
+
+	return pointer;
+}
+
+void* oolong_memory_reallocate(void* pointer, size_t count, size_t size)
+{
+	size_t total;
+
+	if (__builtin_mul_overflow(count, size, &total))
+		return NULL;
+
+	atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+	return allocator.reallocate(allocator.user, pointer, total);
+}
+
+void oolong_memory_free(void* pointer)
+{
+	if (pointer != NULL)
+		allocator.free(allocator.user, pointer);
+}
+
+size_t oolong_memory_get_allocations(void)
+{
+	return atomic_load_explicit(&allocations, memory_order_relaxed);
+}
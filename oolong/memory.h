@@ -0,0 +1,55 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_MEMORY_H
+#define OOLONG_MEMORY_H
+
+#include <stddef.h>
+#include "error.h"
+
+typedef struct oolong_allocator_s oolong_allocator_t;
+
+/*
+ * Functions oolong gets its heap memory from, each given the allocator's user
+ * pointer first. They should behave as malloc(), realloc(), and free() do, and
+ * must be safe to call from several threads at once if elements are rendered
+ * on more than one thread.
+ */
+struct oolong_allocator_s
+{
+	void* (*allocate)(void* user, size_t size);
+	void* (*reallocate)(void* user, void* pointer, size_t size);
+	void (*free)(void* user, void* pointer);
+	void* user;
+};
+
+/*
+ * Sets the allocator used for all of oolong's heap memory from then on, or
+ * goes back to malloc(), realloc(), and free() if given NULL. The allocator is
+ * copied. Memory must be freed by the allocator that allocated it, so this
+ * should be done before creating anything and not again while anything made
+ * with the previous allocator is alive.
+ */
+oolong_error_t oolong_memory_set_allocator(const oolong_allocator_t* allocator);
+
+/*
+ * All of oolong's heap memory goes through these functions so that it can be
+ * counted and come from the set allocator, they otherwise behave as malloc(),
+ * calloc(), reallocarray(), and free() do. Anything oolong gives out that the
+ * caller is to free, such as an element's rendered string, should be freed
+ * with oolong_memory_free().
+ */
+void* oolong_memory_allocate(size_t size);
+void* oolong_memory_allocate_zeroed(size_t count, size_t size);
+void* oolong_memory_reallocate(void* pointer, size_t count, size_t size);
+void oolong_memory_free(void* pointer);
+
+/*
+ * Gets the number of allocations and reallocations oolong has made, from any
+ * thread, since the program started.
+ */
+size_t oolong_memory_get_allocations(void);
+
+#endif // OOLONG_MEMORY_H
@@ -15,8 +15,19 @@
 #include "keyboard.h"
 #include "screen.h"
 #include "styling.h"
+#include "width.h"
+#include "grapheme.h"
+#include "wrap.h"
+#include "virtual_terminal.h"
+#include "memory.h"
+#include "arena.h"
+#include "frame.h"
+#include "latency.h"
+#include "capture.h"
 
 #include "stack_view.h"
+#include "grid_view.h"
+#include "layout.h"
 #include "element.h"
 #include "label.h"
 #include "button.h"
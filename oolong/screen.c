@@ -9,11 +9,14 @@
 
 typedef struct winsize window_size_t;
 
+static unsigned int pinned_columns = 0;
+static unsigned int pinned_rows = 0;
+
 oolong_error_t oolong_get_screen_dimensions(unsigned int* columns, unsigned int* rows)
 {
-    window_size_t window_size;
+    window_size_t window_size = { .ws_col = pinned_columns, .ws_row = pinned_rows };
 
-    if (ioctl(STDIN_FILENO, TIOCGWINSZ, &window_size) == -1)
+    if (pinned_columns == 0 && ioctl(STDIN_FILENO, TIOCGWINSZ, &window_size) == -1)
         return oolong_error_record(OOLONG_ERROR_FAILED_IO_READ);
 
     if (columns != NULL)
@@ -25,3 +28,12 @@ oolong_error_t oolong_get_screen_dimensions(unsigned int* columns, unsigned int*
     return OOLONG_ERROR_NONE;
 }
 
+oolong_error_t oolong_set_screen_dimensions(unsigned int columns, unsigned int rows)
+{
+    if ((columns == 0) != (rows == 0))
+        return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+    pinned_columns = columns;
+    pinned_rows = rows;
+    return OOLONG_ERROR_NONE;
+}
@@ -21,5 +21,12 @@
  */
 oolong_error_t oolong_get_screen_dimensions(unsigned int* columns, unsigned int* rows);
 
+/*
+ * Pins the dimensions given by oolong_get_screen_dimensions() instead of
+ * asking the terminal, for rendering to something other than a terminal such
+ * as a virtual terminal or a file. Giving zero for both unpins them.
+ */
+oolong_error_t oolong_set_screen_dimensions(unsigned int columns, unsigned int rows);
+
 #endif // OOLONG_SCREEN_H
 
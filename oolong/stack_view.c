@@ -4,149 +4,305 @@
  */
 
 #include <stdio.h>
+#include <wchar.h>
 #include "error.h"
 #include "screen.h"
+#include "frame.h"
 #include "stack_view.h"
 
-static oolong_error_t print_left_aligned(oolong_stack_view_t* view, file_t* file)
+/*
+ * Puts the given number of characters from a string into the frame.
+ */
+static oolong_error_t put_string(const wchar_t* string, size_t length)
 {
-	unsigned int columns;
-	unsigned int content_columns;
+	if (length == 0)
+		return OOLONG_ERROR_NONE;
 
-	oolong_get_screen_dimensions(&columns, NULL);
-	content_columns = columns - (2 * view->margin_sides);
+	wchar_t* destination = oolong_frame_reserve(length);
 
-	for (size_t index = 0; view->elements[index]; index++)
-	{
-		for (unsigned int i = 0; i < view->margin_sides; i++)
-			putwc(L' ', file);
+	if (destination == NULL)
+		return oolong_error_get_last().error;
 
-		oolong_element_render_string(view->elements[index]);
-		wchar_t* element_string = oolong_element_get_string(view->elements[index]);
+	wmemcpy(destination, string, length);
+	return OOLONG_ERROR_NONE;
+}
 
-		for (size_t element_string_index = 0; element_string[element_string_index] != L'\0'; element_string_index++)
-		{
-			if ((element_string_index - oolong_element_get_preceding_style_size(view->elements[index])) % (content_columns - 1))
-				putwc(L'\n', file);
+/*
+ * Puts an element's rendered string into the frame, or renders it straight
+ * into the frame if the view renders directly.
+ */
+static oolong_error_t put_element(oolong_stack_view_t* view, oolong_element_t* element)
+{
+	if (view->render_direct)
+		return oolong_element_render_to_frame(element);
 
-			putwc(element_string[element_string_index], file);
-		}
+	return put_string(oolong_element_get_string(element), oolong_element_get_string_length(element));
+}
 
-		if (view->elements[index + 1])
-			for (unsigned int i = 0; i < view->element_gap; i++)
-				putwc(L'\n', file);
+/*
+ * Puts an element followed by a newline. Elements wider than the view have
+ * their content word wrapped within their padding instead, as described for
+ * oolong_element_compose_line(), with the view's margin before each line.
+ */
+static oolong_error_t put_wrapped(oolong_stack_view_t* view, oolong_element_t* element, unsigned int content_columns)
+{
+	oolong_error_t error;
+
+	if (oolong_element_get_string_width(element) <= content_columns)
+	{
+		error = put_element(view, element);
+		return error != OOLONG_ERROR_NONE ? error : oolong_frame_fill(L'\n', 1);
 	}
 
-	if (ferror(file))
-		return oolong_error_record(OOLONG_ERROR_FAILED_IO_WRITE);
+	size_t height = oolong_element_get_height(element, content_columns);
+
+	for (size_t line = 0; line < height; line++)
+	{
+		if (line > 0 && (error = oolong_frame_fill(L' ', view->margin_sides)) != OOLONG_ERROR_NONE)
+			return error;
+
+		if ((error = oolong_element_compose_line(element, content_columns, line)) != OOLONG_ERROR_NONE)
+			return error;
+
+		if ((error = oolong_frame_fill(L'\n', 1)) != OOLONG_ERROR_NONE)
+			return error;
+	}
 
 	return OOLONG_ERROR_NONE;
 }
 
-static oolong_error_t print_center_aligned(oolong_stack_view_t* view, file_t* file)
+/*
+ * Puts every element of the view after the number of spaces the given function
+ * finds for it, with the view's gap between elements. Only left and width
+ * aligned views wrap elements wider than the view.
+ */
+static oolong_error_t put_elements(oolong_stack_view_t* view, unsigned int content_columns, unsigned int (*get_preceding_spaces)(oolong_stack_view_t*, oolong_element_t*, unsigned int))
 {
-	unsigned int columns;
-	unsigned int content_columns;
-
-	oolong_get_screen_dimensions(&columns, NULL);
-	content_columns = columns - (2 * view->margin_sides);
+	oolong_error_t error;
 
 	for (size_t index = 0; view->elements[index]; index++)
 	{
-		oolong_element_render_string(view->elements[index]);
-		
-		unsigned int preceding_spaces = 0;
-		wchar_t* element_string = oolong_element_get_string(view->elements[index]);
-		size_t element_string_length = wcslen(element_string) - oolong_element_get_preceding_style_size(view->elements[index]) - oolong_element_get_following_style_size(view->elements[index]);
+		oolong_element_t* element = view->elements[index];
 
-		if (element_string_length < content_columns)
-		{
-			unsigned int total_spaces = content_columns - element_string_length;
-			unsigned int remainder = total_spaces % content_columns;
-			preceding_spaces = (total_spaces - remainder) / 2;
-		}
+		/* 
+		 * Rendering directly leaves the strings alone, so only the widths aligning
+		 * needs are measured, just before the element is put so that the layout
+		 * measuring works out is used again to render it.
+		 */
+		if (view->render_direct && (error = oolong_element_measure(element)) != OOLONG_ERROR_NONE)
+			return error;
 
-		for (unsigned int i = 0; i < preceding_spaces; i++)
-			putwc(L' ', file);
+		if ((error = oolong_frame_fill(L' ', get_preceding_spaces(view, element, content_columns))) != OOLONG_ERROR_NONE)
+			return error;
 
-		fwprintf(file, L"%ls\n", element_string);
+		if (view->alignment == OOLONG_ALIGN_LEFT || view->alignment == OOLONG_ALIGN_WIDTH)
+			error = put_wrapped(view, element, content_columns);
+		else if ((error = put_element(view, element)) == OOLONG_ERROR_NONE)
+			error = oolong_frame_fill(L'\n', 1);
 
-		if (view->elements[index + 1] != NULL)
-			for (unsigned int i = 0; i < view->element_gap; i++)
-				putwc(L'\n', file);
-	}
+		if (error != OOLONG_ERROR_NONE)
+			return error;
 
-	if (ferror(file))
-		return oolong_error_record(OOLONG_ERROR_FAILED_IO_WRITE);
+		if (view->elements[index + 1] != NULL && (error = oolong_frame_fill(L'\n', view->element_gap)) != OOLONG_ERROR_NONE)
+			return error;
+	}
 
 	return OOLONG_ERROR_NONE;
 }
 
-static oolong_error_t print_right_aligned(oolong_stack_view_t* view, file_t* file)
+static unsigned int get_left_aligned_spaces(oolong_stack_view_t* view, oolong_element_t* element, unsigned int content_columns)
 {
-	unsigned int columns;
-	unsigned int content_columns;
+	(void)element;
+	(void)content_columns;
+	return view->margin_sides;
+}
+
+static unsigned int get_center_aligned_spaces(oolong_stack_view_t* view, oolong_element_t* element, unsigned int content_columns)
+{
+	size_t element_string_width = oolong_element_get_string_width(element);
+
+	if (element_string_width >= content_columns)
+		return view->margin_sides;
+
+	unsigned int total_spaces = content_columns - element_string_width;
+	unsigned int remainder = total_spaces % 2;
+	return view->margin_sides + (total_spaces - remainder) / 2;
+}
+
+static unsigned int get_right_aligned_spaces(oolong_stack_view_t* view, oolong_element_t* element, unsigned int content_columns)
+{
+	size_t element_string_width = oolong_element_get_string_width(element);
 
+	if (element_string_width >= content_columns)
+		return view->margin_sides;
+
+	return view->margin_sides + content_columns - element_string_width;
+}
+
+oolong_error_t oolong_stack_view_print(oolong_stack_view_t* view, file_t* file)
+{
+	if (view == NULL || file == NULL || view->elements == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (oolong_frame_begin() == NULL)
+		return oolong_error_get_last().error;
+
+	unsigned int columns;
 	oolong_get_screen_dimensions(&columns, NULL);
-	content_columns = columns - (2 * view->margin_sides);
+	unsigned int content_columns = columns - (2 * view->margin_sides);
+	unsigned int (*get_preceding_spaces)(oolong_stack_view_t*, oolong_element_t*, unsigned int);
+	size_t elements_length = 0;
 
-	for (size_t index = 0; view->elements[index]; index++)
+	for (; view->elements[elements_length]; elements_length++)
+		if (view->alignment == OOLONG_ALIGN_WIDTH)
+			view->elements[elements_length]->width = content_columns;
+
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_LAYOUT);
+	oolong_error_t error;
+
+	if (!view->render_direct)
 	{
-		oolong_element_render_string(view->elements[index]);
+		error = oolong_element_render_strings(view->elements, view->render_threads);
 
-		wchar_t* element_string = oolong_element_get_string(view->elements[index]);
-		unsigned int preceding_spaces = 0;
-		size_t element_string_length = wcslen(element_string) - oolong_element_get_preceding_style_size(view->elements[index]) - oolong_element_get_following_style_size(view->elements[index]);
+		if (error != OOLONG_ERROR_NONE)
+			return error;
 
-		if (element_string_length < content_columns)
-			preceding_spaces = content_columns - element_string_length;
+		size_t elements_reused = 0;
 
-		for (unsigned int i = 0; i < preceding_spaces; i++)
-			putwc(L' ', file);
+		for (size_t index = 0; index < elements_length; index++)
+			elements_reused += view->elements[index]->reused;
 
-		fwprintf(file, L"%ls\n", element_string);
+		oolong_frame_count_elements(elements_length - elements_reused, elements_reused);
+	}
+	else
+	{
+		oolong_frame_count_elements(elements_length, 0);
+	}
 
-		if (view->elements[index + 1])
-			for (unsigned int i = 0; i < view->element_gap; i++)
-				putwc(L'\n', file);
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_RENDER);
+
+	switch (view->alignment)
+	{
+		case (OOLONG_ALIGN_LEFT):
+		case (OOLONG_ALIGN_WIDTH):	get_preceding_spaces = get_left_aligned_spaces;		break;
+		case (OOLONG_ALIGN_CENTER):	get_preceding_spaces = get_center_aligned_spaces;	break;
+		case (OOLONG_ALIGN_RIGHT):	get_preceding_spaces = get_right_aligned_spaces;	break;
+		default:					return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
 	}
 
-	if (ferror(file))
-		return oolong_error_record(OOLONG_ERROR_FAILED_IO_WRITE);
+	error = oolong_frame_fill(L'\n', view->margin_top);
 
-	return OOLONG_ERROR_NONE;
+	if (error == OOLONG_ERROR_NONE)
+		error = put_elements(view, content_columns, get_preceding_spaces);
+
+	if (error != OOLONG_ERROR_NONE)
+		return error;
+
+	oolong_frame_end_phase(OOLONG_FRAME_PHASE_COMPOSE);
+	return view->diff_rows ? oolong_frame_present_rows(file) : oolong_frame_present(file);
 }
 
-static oolong_error_t print_width_aligned(oolong_stack_view_t* view, file_t* file)
+size_t oolong_stack_view_get_width(oolong_stack_view_t* view)
 {
-	unsigned int columns;
-	unsigned int content_columns;
+	if (view == NULL || view->elements == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
 
-	oolong_get_screen_dimensions(&columns, NULL);
-	content_columns = columns - (2 * view->margin_sides);
+	size_t width = 0;
 
 	for (size_t index = 0; view->elements[index]; index++)
-		view->elements[index]->width = content_columns;
+	{
+		size_t element_width = oolong_element_get_string_width(view->elements[index]);
+		width = element_width > width ? element_width : width;
+	}
 
-	return print_left_aligned(view, file);
+	return width + 2 * view->margin_sides;
 }
 
-oolong_error_t oolong_stack_view_print(oolong_stack_view_t* view, file_t* file)
+/*
+ * Gets the columns left for elements between a view's margins.
+ */
+static unsigned int get_content_columns(oolong_stack_view_t* view, unsigned int columns)
 {
-	if (view == NULL || file == NULL || view->elements == NULL)
+	return columns > 2 * view->margin_sides ? columns - 2 * view->margin_sides : 0;
+}
+
+size_t oolong_stack_view_get_height(oolong_stack_view_t* view, unsigned int columns)
+{
+	if (view == NULL || view->elements == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	unsigned int content_columns = get_content_columns(view, columns);
+	size_t height = view->margin_top;
+
+	for (size_t index = 0; view->elements[index]; index++)
+		height += oolong_element_get_height(view->elements[index], content_columns) + (index > 0 ? view->element_gap : 0);
+
+	return height;
+}
+
+oolong_error_t oolong_stack_view_compose_line(oolong_stack_view_t* view, unsigned int columns, oolong_stack_view_cursor_t* cursor)
+{
+	if (view == NULL || view->elements == NULL || cursor == NULL)
 		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
 
-	for (unsigned int i = 0; i < view->margin_top; i++)
-		putwc(L'\n', file);
+	oolong_element_t* element = NULL;
+	size_t height = 0;
+	unsigned int content_columns = get_content_columns(view, columns);
 
-	switch (view->alignment)
+	/* Nothing fits between the margins. */
+	if (content_columns == 0)
 	{
-		case (OOLONG_ALIGN_LEFT):	return print_left_aligned(view, file);
-		case (OOLONG_ALIGN_CENTER):	return print_center_aligned(view, file);
-		case (OOLONG_ALIGN_RIGHT):	return print_right_aligned(view, file);
-		case (OOLONG_ALIGN_WIDTH):	return print_width_aligned(view, file);
+		cursor->line++;
+		return oolong_frame_fill(L' ', columns);
 	}
 
-	return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
-}
+	/* Moves past an element and the gap after it once all of their lines are put. */
+	if (cursor->line >= view->margin_top && (element = view->elements[cursor->element]) != NULL)
+	{
+		height = oolong_element_get_height(element, content_columns);
+		size_t gap = view->elements[cursor->element + 1] != NULL ? view->element_gap : 0;
+
+		if (cursor->element_line >= height + gap)
+		{
+			cursor->element++;
+			cursor->element_line = 0;
+
+			if ((element = view->elements[cursor->element]) != NULL)
+				height = oolong_element_get_height(element, content_columns);
+		}
+	}
+
+	cursor->line++;
+
+	/* Margins, gaps, and lines past the end are blank. */
+	if (element == NULL || cursor->element_line >= height)
+	{
+		cursor->element_line += element != NULL;
+		return oolong_frame_fill(L' ', columns);
+	}
 
+	size_t line = cursor->element_line++;
+	size_t string_width = oolong_element_get_string_width(element);
+	unsigned int preceding_spaces = 0;
+
+	if (string_width < content_columns && view->alignment == OOLONG_ALIGN_CENTER)
+		preceding_spaces = (content_columns - string_width) / 2;
+	else if (string_width < content_columns && view->alignment == OOLONG_ALIGN_RIGHT)
+		preceding_spaces = content_columns - string_width;
+
+	oolong_error_t error = oolong_frame_fill(L' ', view->margin_sides + preceding_spaces);
+
+	if (error == OOLONG_ERROR_NONE)
+		error = oolong_element_compose_line(element, content_columns - preceding_spaces, line);
+
+	if (error == OOLONG_ERROR_NONE)
+		error = oolong_frame_fill(L' ', columns - view->margin_sides - content_columns);
+
+	return error;
+}
@@ -15,17 +15,67 @@ struct oolong_stack_view_s
 	unsigned int margin_top;		/* Number of newlines from top of terminal to first element. */
 	unsigned int margin_sides;		/* Number of spaces of either side to an element. */
 	unsigned int element_gap;		/* Number of newlines between elements. */
+	unsigned int render_threads;	/* Threads to render elements with, 0 or 1 renders serially, as do elements in an arena. */
+	bool render_direct;				/* Render elements straight into the frame rather than into their strings. */
+	bool diff_rows;					/* Write only the rows changed since the last print, see oolong_frame_present_rows(). */
+};
+
+/*
+ * Where a stack view being composed a line at a time, as a grid view does with
+ * the stack views in its cells, is up to. Zeroed it starts at the view's top.
+ */
+struct oolong_stack_view_cursor_s
+{
+	size_t line;			/* Line of the view the cursor is on. */
+	size_t element;			/* Index of the element the line belongs to, or follows as part of the gap. */
+	size_t element_line;	/* Line of that element, lines past its height being the gap after it. */
 };
 
 typedef FILE file_t;
 typedef struct oolong_stack_view_s oolong_stack_view_t;
+typedef struct oolong_stack_view_cursor_s oolong_stack_view_cursor_t;
 
 /*
  * Prints the given stack view to the given file. If the view is width aligned
  * then this function will change the view's element's widths to align to the
  * terminal properly.
+ *
+ * Printing is a frame with the phases described in frame.h. Every element is
+ * rendered, across the view's render threads if there are enough elements, and
+ * then the rendered strings are composed into the frame's buffer and written
+ * to the file at once from the calling thread. Statistics of the print can be
+ * read afterwards with oolong_frame_get_stats().
+ *
+ * A view that renders directly instead renders each element straight into the
+ * frame's output while composing, on the calling thread, so no element's
+ * string is touched or copied. Unchanged elements cannot be reused that way,
+ * so this suits views whose elements change every frame.
  */
 oolong_error_t oolong_stack_view_print(oolong_stack_view_t* view, file_t* file);
 
+/*
+ * Gets the number of columns the view needs to show every element without
+ * wrapping, its widest element and its side margins. The elements must have
+ * been rendered.
+ */
+size_t oolong_stack_view_get_width(oolong_stack_view_t* view);
+
+/*
+ * Gets the number of lines the view takes up when laid out in the given number
+ * of columns, including its top margin and gaps. The elements must have been
+ * rendered.
+ */
+size_t oolong_stack_view_get_height(oolong_stack_view_t* view, unsigned int columns);
+
+/*
+ * Puts the cursor's line of the view, laid out in the given number of columns,
+ * into the current frame's output filled out with spaces to exactly that width
+ * and moves the cursor to the next line. Elements are aligned as they would be
+ * when printed and word wrapped if too wide whatever the alignment, width
+ * alignment being treated as left alignment. Lines past the view's height are
+ * blank. The elements must have been rendered.
+ */
+oolong_error_t oolong_stack_view_compose_line(oolong_stack_view_t* view, unsigned int columns, oolong_stack_view_cursor_t* cursor);
+
 #endif // OOLONG_STACK_VIEW_H
 
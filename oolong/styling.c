@@ -3,6 +3,7 @@
  * See LICENSE file in repository root for complete license text.
  */
 
+#include "memory.h"
 #include "styling.h"
 #include <stdio.h>
 
@@ -32,7 +33,7 @@ static const wchar_t* style_escapes[] =
 
 oolong_style_set_t* oolong_style_set_create()
 {
-    oolong_style_set_t* style_set = calloc(1, sizeof *style_set);
+    oolong_style_set_t* style_set = oolong_memory_allocate_zeroed(1, sizeof *style_set);
     style_set[0] = L'\0';
     return style_set;
 }
@@ -52,7 +53,7 @@ oolong_error_t oolong_style_set_add(oolong_style_set_t** style_set, oolong_style
     size_t set_length = wcslen(*style_set);
     size_t style_length = wcslen(style_escapes[style]) + 1;
     
-    oolong_style_set_t* new_set = reallocarray(*style_set, set_length + style_length, sizeof(oolong_style_t));
+    oolong_style_set_t* new_set = oolong_memory_reallocate(*style_set, set_length + style_length, sizeof(oolong_style_t));
 
     if (new_set == NULL)
         return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
@@ -75,7 +76,7 @@ oolong_error_t oolong_style_set_destroy(oolong_style_set_t* style_set)
      * need to free them.
      */
     
-    free(style_set);
+    oolong_memory_free(style_set);
     return OOLONG_ERROR_NONE;
 }
 
@@ -3,6 +3,7 @@
  * See LICENSE file in repository root for complete license text.
  */
 
+#include "memory.h"
 #include "text_box.h"
 
 struct oolong_text_box_s
@@ -10,6 +11,9 @@ struct oolong_text_box_s
 	oolong_element_t element_data;
 	wchar_t* display_text;
 	wchar_t* entered_text;
+	size_t entered_text_length;			/* Characters in 'entered_text', not counting its terminator. */
+	size_t entered_text_capacity;		/* Characters 'entered_text' has room for, not counting its terminator. */
+	wchar_t inline_string[OOLONG_ELEMENT_INLINE_STRING_LENGTH + 1];
 	oolong_key_t* activation_keys;
 	oolong_key_t* deactivation_keys;
 };
@@ -26,7 +30,25 @@ static bool contains_key(oolong_key_t* key_array, oolong_key_t key)
 	return false;
 }
 
+/*
+ * Frees what the text box holds outside of its own memory and arena.
+ */
+static void release(void* object)
+{
+	oolong_text_box_t* text_box = object;
+
+	if (text_box->element_data.style_normal != NULL)
+		oolong_style_set_destroy(text_box->element_data.style_normal);
+
+	oolong_element_destroy_caches(&text_box->element_data);
+}
+
 oolong_text_box_t* oolong_text_box_create(oolong_text_box_options_t* options)
+{
+	return oolong_text_box_create_in(NULL, options);
+}
+
+oolong_text_box_t* oolong_text_box_create_in(oolong_arena_t* arena, oolong_text_box_options_t* options)
 {
 	if (options == NULL)
 	{
@@ -34,7 +56,7 @@ oolong_text_box_t* oolong_text_box_create(oolong_text_box_options_t* options)
 		return NULL;
 	}
 
-	oolong_text_box_t* text_box = malloc(sizeof *text_box);
+	oolong_text_box_t* text_box = arena == NULL ? oolong_memory_allocate(sizeof *text_box) : oolong_arena_allocate(arena, sizeof *text_box);
 
 	if (text_box == NULL)
 	{
@@ -45,7 +67,26 @@ oolong_text_box_t* oolong_text_box_create(oolong_text_box_options_t* options)
 	text_box->activation_keys		= options->activations_keys;
 	text_box->deactivation_keys		= options->activations_keys;
 	text_box->display_text			= options->display_text;
-	text_box->entered_text			= calloc(1, sizeof *text_box->entered_text);
+	text_box->entered_text_length	= 0;
+	text_box->entered_text_capacity	= 0;
+	text_box->element_data.arena	= arena;
+	text_box->element_data.cold		= NULL;
+	text_box->entered_text			= oolong_element_reallocate(&text_box->element_data, NULL, 0, sizeof *text_box->entered_text);
+
+	if (text_box->entered_text == NULL
+		|| oolong_element_set_style(&text_box->element_data, OOLONG_ELEMENT_STATE_SELECTED, options->style_selected) != OOLONG_ERROR_NONE
+		|| oolong_element_set_style(&text_box->element_data, OOLONG_ELEMENT_STATE_ACTIVE, options->style_active) != OOLONG_ERROR_NONE
+		|| oolong_element_set_style(&text_box->element_data, OOLONG_ELEMENT_STATE_DISABLED, options->style_disabled) != OOLONG_ERROR_NONE
+		|| (arena != NULL && oolong_arena_track(arena, text_box, release) != OOLONG_ERROR_NONE))
+	{
+		oolong_element_destroy_caches(&text_box->element_data);
+		oolong_element_free(&text_box->element_data, text_box->entered_text, sizeof *text_box->entered_text);
+		oolong_element_free(&text_box->element_data, text_box, sizeof *text_box);
+		oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+		return NULL;
+	}
+
+	text_box->entered_text[0]		= L'\0';
 
 	text_box->element_data.identifier 			= options->identifier;
 	text_box->element_data.supported_states 	= OOLONG_TEXT_BOX_SUPPORTED_STATES;
@@ -54,11 +95,14 @@ oolong_text_box_t* oolong_text_box_create(oolong_text_box_options_t* options)
 	text_box->element_data.padding 				= options->padding;
 	text_box->element_data.width 				= options->width;
 	text_box->element_data.style_normal 		= options->style_normal;
-	text_box->element_data.style_selected 		= options->style_selected;
-	text_box->element_data.style_active			= options->style_active;
-	text_box->element_data.style_disabled 		= options->style_disabled;
 	text_box->element_data.string 				= NULL;
+	text_box->element_data.inline_string		= text_box->inline_string;
+	text_box->element_data.string_capacity		= 0;
 	text_box->element_data.content				= text_box->display_text;
+	text_box->element_data.measured_content		= NULL;
+	text_box->element_data.sized_content		= NULL;
+	text_box->element_data.content_length		= 0;
+	text_box->element_data.string_length		= 0;
 	
 	return text_box;
 }
@@ -68,12 +112,44 @@ oolong_error_t oolong_text_box_destroy(oolong_text_box_t* text_box)
 	if (text_box == NULL)
 		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
 
-	oolong_style_set_destroy(text_box->element_data.style_normal);
-	free(text_box->element_data.string);
-	free(text_box);
+	oolong_element_t* element = &text_box->element_data;
+	oolong_arena_t* arena = element->arena;
+
+	release(text_box);
+	oolong_element_free_string(element);
+	oolong_element_free(element, text_box->entered_text, (text_box->entered_text_capacity + 1) * sizeof *text_box->entered_text);
+
+	if (arena == NULL)
+	{
+		oolong_memory_free(text_box);
+		return OOLONG_ERROR_NONE;
+	}
+
+	oolong_arena_untrack(arena, text_box);
+	oolong_arena_free(arena, text_box, sizeof *text_box);
 	return OOLONG_ERROR_NONE;
 }
 
+/*
+ * Points the text box's content at the entered text or display text as
+ * appropriate after the entered text was edited at the given index.
+ */
+static oolong_error_t update_content(oolong_text_box_t* text_box, size_t edit_index)
+{
+	if (text_box->element_data.state != OOLONG_ELEMENT_STATE_ACTIVE && text_box->entered_text[0] == L'\0')
+		return oolong_element_set_content(&text_box->element_data, text_box->display_text);
+
+	/* 
+	 * Editing at the end of the entered text leaves everything cached about the
+	 * text before the edit intact, so only say what actually changed.
+	 */
+
+	if (text_box->element_data.content == text_box->entered_text)
+		return oolong_element_invalidate_content(&text_box->element_data, edit_index, text_box->entered_text_length);
+
+	return oolong_element_set_content_slice(&text_box->element_data, text_box->entered_text, text_box->entered_text_length);
+}
+
 oolong_error_t oolong_text_box_register_keystroke(oolong_text_box_t* text_box, oolong_key_t key)
 {
 	if (text_box == NULL || key == KEY_NULL || key == KEY_ERROR)
@@ -82,19 +158,19 @@ oolong_error_t oolong_text_box_register_keystroke(oolong_text_box_t* text_box, o
 	if (key == KEY_STRING)
 		return OOLONG_ERROR_NONE;
 
+	size_t entered_text_length = text_box->entered_text_length;
+
 	if (text_box->element_data.state == OOLONG_ELEMENT_STATE_SELECTED && contains_key(text_box->activation_keys, key))
 	{
 		text_box->element_data.state = OOLONG_ELEMENT_STATE_ACTIVE;
-		goto update_content;
+		return update_content(text_box, entered_text_length);
 	}
 
 	if (text_box->element_data.state == OOLONG_ELEMENT_STATE_ACTIVE && contains_key(text_box->deactivation_keys, key))
 	{
 		text_box->element_data.state = OOLONG_ELEMENT_STATE_SELECTED;
-		goto update_content;
+		return update_content(text_box, entered_text_length);
 	}
-
-	size_t entered_text_length = wcslen(text_box->entered_text);
 	
 	if (key == KEY_BACKSPACE)
 	{
@@ -102,20 +178,23 @@ oolong_error_t oolong_text_box_register_keystroke(oolong_text_box_t* text_box, o
 			return OOLONG_ERROR_NONE;
 
 		/*
-		 * This reallocation is not strictly necessary but I do it anyways since it 
-		 * will prevent text boxes from taking up an abatrary amount of memory. Bonous
-		 * is that reallocating to less memory costs very little.
+		 * Backspace removes a whole grapheme cluster so that an accented letter or
+		 * emoji sequence is never left half deleted. Non empty entered text is
+		 * always the content, so the element's cached boundaries can be used and
+		 * finding the last cluster is a single lookup.
 		 */
 
-		wchar_t* new_text = reallocarray(text_box->entered_text, entered_text_length, sizeof *text_box->entered_text);
-		entered_text_length--;
+		oolong_graphemes_t* graphemes = oolong_element_get_graphemes(&text_box->element_data);
 
-		if (new_text == NULL)
-			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+		if (graphemes == NULL)
+			return oolong_error_get_last().error;
 
-		text_box->entered_text[entered_text_length] = L'\0';
-		text_box->entered_text = new_text;
-		goto update_content;
+		size_t new_length = oolong_graphemes_get_start(graphemes, graphemes->count - 1);
+
+		/* The memory is kept for whatever is typed next rather than shrunk. */
+		text_box->entered_text[new_length] = L'\0';
+		text_box->entered_text_length = new_length;
+		return update_content(text_box, new_length);
 	}
 
 	/*
@@ -125,26 +204,39 @@ oolong_error_t oolong_text_box_register_keystroke(oolong_text_box_t* text_box, o
 	if (key < KEY_SPACE || key > KEY_TILDE)
 		return OOLONG_ERROR_NONE;
 
-	wchar_t* new_text = reallocarray(text_box->entered_text, entered_text_length + 2, sizeof *text_box->entered_text);
-	entered_text_length++;
+	wchar_t character[] = { (wchar_t)key, L'\0' };
+	return oolong_text_box_insert_text(text_box, character);
+}
+
+oolong_error_t oolong_text_box_insert_text(oolong_text_box_t* text_box, const wchar_t* text)
+{
+	if (text_box == NULL || text == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
 
-	if (new_text == NULL)
-		return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+	size_t entered_text_length = text_box->entered_text_length;
+	size_t text_length = wcslen(text);
 
-	text_box->entered_text = new_text;
-	text_box->entered_text[entered_text_length] = L'\0';
-	text_box->entered_text[entered_text_length - 1] = (wchar_t)key;
-	goto update_content;
-	
-update_content:
-	if (text_box->element_data.state == OOLONG_ELEMENT_STATE_ACTIVE || wcslen(text_box->entered_text) > 0)
+	/* Doubling means typing only allocates a handful of times however much is typed. */
+	if (entered_text_length + text_length > text_box->entered_text_capacity)
 	{
-		text_box->element_data.content = text_box->entered_text;
-		return OOLONG_ERROR_NONE;
+		size_t capacity = text_box->entered_text_capacity < 16 ? 16 : text_box->entered_text_capacity * 2;
+
+		while (capacity < entered_text_length + text_length)
+			capacity *= 2;
+
+		size_t old_size = (text_box->entered_text_capacity + 1) * sizeof *text_box->entered_text;
+		wchar_t* new_text = oolong_element_reallocate(&text_box->element_data, text_box->entered_text, old_size, (capacity + 1) * sizeof *text_box->entered_text);
+
+		if (new_text == NULL)
+			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+		text_box->entered_text = new_text;
+		text_box->entered_text_capacity = capacity;
 	}
 
-	text_box->element_data.content = text_box->display_text;
-	return OOLONG_ERROR_NONE;
+	wmemcpy(&text_box->entered_text[entered_text_length], text, text_length + 1);
+	text_box->entered_text_length += text_length;
+	return update_content(text_box, entered_text_length);
 }
 
 wchar_t* oolong_text_box_get_entered_text(oolong_text_box_t* text_box)
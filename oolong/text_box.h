@@ -38,6 +38,14 @@ struct oolong_text_box_options_s
  */
 oolong_text_box_t* oolong_text_box_create(oolong_text_box_options_t* options);
 
+/*
+ * Creates a text box as oolong_text_box_create() does but keeps it, its entered
+ * text, and its rendered string in the given arena, or on the heap if the arena
+ * is NULL. The text box may still be destroyed on its own, otherwise destroying
+ * the arena destroys it.
+ */
+oolong_text_box_t* oolong_text_box_create_in(oolong_arena_t* arena, oolong_text_box_options_t* options);
+
 /*
  * Frees all memory used by the text box. This will not free the content member
  * given with the options struct while creating the text box.
@@ -53,6 +61,13 @@ oolong_error_t oolong_text_box_destroy(oolong_text_box_t* text_box);
  */
 oolong_error_t oolong_text_box_register_keystroke(oolong_text_box_t* text_box, oolong_key_t key);
 
+/*
+ * Appends the given text to the text box's entered text regardless of its
+ * state, for text that does not arrive as single keys such as pasted or wide
+ * characters. Backspace later removes it one grapheme cluster at a time.
+ */
+oolong_error_t oolong_text_box_insert_text(oolong_text_box_t* text_box, const wchar_t* text);
+
 /*
  * Get the user entered text from the given text box.
  */
@@ -0,0 +1,636 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include "memory.h"
+#include "width.h"
+#include "virtual_terminal.h"
+
+#define ESCAPE 0x1B
+#define TAB_STOP 8
+#define READ_CHUNK 4096
+
+enum parser_state_e
+{
+	PARSER_GROUND,
+	PARSER_ESCAPE,
+	PARSER_CONTROL_SEQUENCE
+};
+
+typedef enum parser_state_e parser_state_t;
+
+struct oolong_virtual_terminal_s
+{
+	unsigned int columns;
+	unsigned int rows;
+	unsigned int cursor_column;
+	unsigned int cursor_row;
+	bool wrap_pending;						/* The last column was written, the next character wraps first. */
+	unsigned int scroll_top;				/* First row of the scroll region. */
+	unsigned int scroll_bottom;				/* Last row of the scroll region. */
+	oolong_virtual_cell_t pen;				/* Attributes and colours new characters are written with. */
+	oolong_virtual_cell_t* cells;
+	oolong_virtual_terminal_stats_t stats;
+	FILE* file;
+
+	/* Parser state. */
+	parser_state_t state;
+	uint32_t code_point;					/* UTF-8 character being decoded. */
+	unsigned int continuation_bytes;		/* Continuation bytes still expected for 'code_point'. */
+	bool private_marker;					/* The control sequence began with '?'. */
+	unsigned int parameters_length;
+	unsigned int parameters[OOLONG_VIRTUAL_TERMINAL_MAX_PARAMETERS];
+};
+
+static const oolong_virtual_cell_t blank_cell =
+{
+	.character = L' ',
+	.attributes = 0,
+	.foreground = -1,
+	.background = -1
+};
+
+static oolong_virtual_cell_t* cell_at(oolong_virtual_terminal_t* terminal, unsigned int column, unsigned int row)
+{
+	return &terminal->cells[(size_t)row * terminal->columns + column];
+}
+
+/*
+ * Blanks cells with the current background colour, as a real terminal erases.
+ */
+static void erase_cells(oolong_virtual_terminal_t* terminal, unsigned int row, unsigned int first_column, unsigned int end_column)
+{
+	oolong_virtual_cell_t erased = blank_cell;
+	erased.background = terminal->pen.background;
+
+	for (unsigned int column = first_column; column < end_column; column++)
+		*cell_at(terminal, column, row) = erased;
+
+	terminal->stats.cells_touched += end_column - first_column;
+}
+
+/*
+ * Moves the rows from 'top' through 'bottom' up by 'lines' when positive and
+ * down when negative, blanking the rows left behind.
+ */
+static void scroll_rows(oolong_virtual_terminal_t* terminal, unsigned int top, unsigned int bottom, int lines)
+{
+	unsigned int region_rows = bottom - top + 1;
+	unsigned int distance = lines < 0 ? -lines : lines;
+
+	if (distance > region_rows)
+		distance = region_rows;
+
+	size_t row_size = terminal->columns * sizeof *terminal->cells;
+	unsigned int moved_rows = region_rows - distance;
+
+	if (lines > 0)
+		memmove(cell_at(terminal, 0, top), cell_at(terminal, 0, top + distance), moved_rows * row_size);
+	else
+		memmove(cell_at(terminal, 0, top + distance), cell_at(terminal, 0, top), moved_rows * row_size);
+
+	unsigned int blank_first = lines > 0 ? bottom + 1 - distance : top;
+
+	for (unsigned int row = blank_first; row < blank_first + distance; row++)
+		erase_cells(terminal, row, 0, terminal->columns);
+
+	terminal->stats.lines_scrolled += distance;
+}
+
+/*
+ * Blanks every cell and homes the cursor, the full reset of ESC c.
+ */
+static void reset_state(oolong_virtual_terminal_t* terminal)
+{
+	for (size_t index = 0; index < (size_t)terminal->columns * terminal->rows; index++)
+		terminal->cells[index] = blank_cell;
+
+	terminal->pen = blank_cell;
+	terminal->cursor_column = 0;
+	terminal->cursor_row = 0;
+	terminal->wrap_pending = false;
+	terminal->scroll_top = 0;
+	terminal->scroll_bottom = terminal->rows - 1;
+}
+
+static void line_feed(oolong_virtual_terminal_t* terminal)
+{
+	if (terminal->cursor_row == terminal->scroll_bottom)
+		scroll_rows(terminal, terminal->scroll_top, terminal->scroll_bottom, 1);
+	else if (terminal->cursor_row + 1 < terminal->rows)
+		terminal->cursor_row++;
+}
+
+static void put_character(oolong_virtual_terminal_t* terminal, wchar_t character)
+{
+	unsigned int width = oolong_width_of_char(character);
+	terminal->stats.characters++;
+
+	/* Combining characters are drawn into the cell before, which is already there. */
+	if (width == 0)
+		return;
+
+	/* A wide character on a screen one column wide can never fit, so it is shown as a replacement. */
+	if (width > terminal->columns)
+	{
+		character = 0xFFFD;
+		width = 1;
+	}
+
+	if (terminal->wrap_pending || terminal->cursor_column + width > terminal->columns)
+	{
+		terminal->cursor_column = 0;
+		terminal->wrap_pending = false;
+		line_feed(terminal);
+	}
+
+	oolong_virtual_cell_t* cell = cell_at(terminal, terminal->cursor_column, terminal->cursor_row);
+	*cell = terminal->pen;
+	cell->character = character;
+	terminal->stats.cells_touched++;
+
+	if (width == 2)
+	{
+		cell[1] = terminal->pen;
+		cell[1].character = L'\0';
+		terminal->stats.cells_touched++;
+	}
+
+	terminal->cursor_column += width;
+
+	if (terminal->cursor_column >= terminal->columns)
+	{
+		terminal->cursor_column = terminal->columns - 1;
+		terminal->wrap_pending = true;
+	}
+}
+
+static void move_cursor(oolong_virtual_terminal_t* terminal, long column, long row)
+{
+	column = column < 0 ? 0 : column >= terminal->columns ? terminal->columns - 1 : column;
+	row = row < 0 ? 0 : row >= terminal->rows ? terminal->rows - 1 : row;
+
+	terminal->cursor_column = column;
+	terminal->cursor_row = row;
+	terminal->wrap_pending = false;
+}
+
+static void select_graphic_rendition(oolong_virtual_terminal_t* terminal)
+{
+	if (terminal->parameters_length == 0)
+		terminal->parameters[terminal->parameters_length++] = 0;
+
+	for (unsigned int index = 0; index < terminal->parameters_length; index++)
+	{
+		unsigned int parameter = terminal->parameters[index];
+
+		switch (parameter)
+		{
+			case 0:		terminal->pen = blank_cell;										break;
+			case 1:		terminal->pen.attributes |= OOLONG_VIRTUAL_ATTRIBUTE_BOLD;		break;
+			case 3:		terminal->pen.attributes |= OOLONG_VIRTUAL_ATTRIBUTE_ITALIC;	break;
+			case 4:		terminal->pen.attributes |= OOLONG_VIRTUAL_ATTRIBUTE_UNDERLINE;	break;
+			case 22:	terminal->pen.attributes &= ~OOLONG_VIRTUAL_ATTRIBUTE_BOLD;		break;
+			case 23:	terminal->pen.attributes &= ~OOLONG_VIRTUAL_ATTRIBUTE_ITALIC;	break;
+			case 24:	terminal->pen.attributes &= ~OOLONG_VIRTUAL_ATTRIBUTE_UNDERLINE;	break;
+			case 39:	terminal->pen.foreground = -1;									break;
+			case 49:	terminal->pen.background = -1;									break;
+
+			default:
+			{
+				if (parameter >= 30 && parameter <= 37)
+					terminal->pen.foreground = parameter - 30;
+				else if (parameter >= 40 && parameter <= 47)
+					terminal->pen.background = parameter - 40;
+
+				break;
+			}
+		}
+	}
+}
+
+static void dispatch_control_sequence(oolong_virtual_terminal_t* terminal, char final)
+{
+	unsigned int* parameters = terminal->parameters;
+	unsigned int first = terminal->parameters_length > 0 ? parameters[0] : 0;
+	unsigned int count = first == 0 ? 1 : first;
+	long column = terminal->cursor_column;
+	long row = terminal->cursor_row;
+
+	terminal->stats.escapes++;
+
+	/* Private modes such as the alternate screen and cursor visibility change nothing here. */
+	if (terminal->private_marker)
+		return;
+
+	switch (final)
+	{
+		case 'H':
+		case 'f':
+		{
+			unsigned int second = terminal->parameters_length > 1 ? parameters[1] : 0;
+			move_cursor(terminal, (long)(second == 0 ? 1 : second) - 1, (long)count - 1);
+			break;
+		}
+
+		case 'A':	move_cursor(terminal, column, row - count);		break;
+		case 'B':	move_cursor(terminal, column, row + count);		break;
+		case 'C':	move_cursor(terminal, column + count, row);		break;
+		case 'D':	move_cursor(terminal, column - count, row);		break;
+		case 'G':	move_cursor(terminal, (long)count - 1, row);	break;
+		case 'd':	move_cursor(terminal, column, (long)count - 1);	break;
+		case 'm':	select_graphic_rendition(terminal);				break;
+
+		case 'J':
+		{
+			unsigned int first_row = first == 0 ? terminal->cursor_row + 1 : 0;
+			unsigned int end_row = first == 1 ? terminal->cursor_row : terminal->rows;
+
+			if (first == 0)
+				erase_cells(terminal, terminal->cursor_row, terminal->cursor_column, terminal->columns);
+			else if (first == 1)
+				erase_cells(terminal, terminal->cursor_row, 0, terminal->cursor_column + 1);
+
+			for (unsigned int erase_row = first_row; erase_row < end_row; erase_row++)
+				erase_cells(terminal, erase_row, 0, terminal->columns);
+
+			break;
+		}
+
+		case 'K':
+		{
+			unsigned int first_column = first == 0 ? terminal->cursor_column : 0;
+			unsigned int end_column = first == 1 ? terminal->cursor_column + 1 : terminal->columns;
+			erase_cells(terminal, terminal->cursor_row, first_column, end_column);
+			break;
+		}
+
+		case 'X':
+		{
+			unsigned int end_column = terminal->cursor_column + count;
+			end_column = end_column > terminal->columns ? terminal->columns : end_column;
+			erase_cells(terminal, terminal->cursor_row, terminal->cursor_column, end_column);
+			break;
+		}
+
+		case 'r':
+		{
+			unsigned int top = first == 0 ? 1 : first;
+			unsigned int bottom = terminal->parameters_length > 1 && parameters[1] != 0 ? parameters[1] : terminal->rows;
+
+			if (top < bottom && bottom <= terminal->rows)
+			{
+				terminal->scroll_top = top - 1;
+				terminal->scroll_bottom = bottom - 1;
+				move_cursor(terminal, 0, 0);
+			}
+
+			break;
+		}
+
+		case 'S':	scroll_rows(terminal, terminal->scroll_top, terminal->scroll_bottom, count);		break;
+		case 'T':	scroll_rows(terminal, terminal->scroll_top, terminal->scroll_bottom, -(int)count);	break;
+
+		case 'L':
+		case 'M':
+		{
+			/* Inserting or deleting lines only happens within the scroll region. */
+			if (terminal->cursor_row < terminal->scroll_top || terminal->cursor_row > terminal->scroll_bottom)
+				break;
+
+			scroll_rows(terminal, terminal->cursor_row, terminal->scroll_bottom, final == 'L' ? -(int)count : (int)count);
+			terminal->cursor_column = 0;
+			terminal->wrap_pending = false;
+			break;
+		}
+	}
+}
+
+static void control_character(oolong_virtual_terminal_t* terminal, uint32_t character)
+{
+	switch (character)
+	{
+		case '\n':
+		{
+			terminal->cursor_column = 0;
+			terminal->wrap_pending = false;
+			line_feed(terminal);
+			break;
+		}
+
+		case '\r':
+		{
+			terminal->cursor_column = 0;
+			terminal->wrap_pending = false;
+			break;
+		}
+
+		case '\b':
+		{
+			if (terminal->cursor_column > 0)
+				terminal->cursor_column--;
+
+			terminal->wrap_pending = false;
+			break;
+		}
+
+		case '\t':
+		{
+			unsigned int next_stop = (terminal->cursor_column / TAB_STOP + 1) * TAB_STOP;
+			terminal->cursor_column = next_stop < terminal->columns ? next_stop : terminal->columns - 1;
+			break;
+		}
+	}
+}
+
+static void parse_byte(oolong_virtual_terminal_t* terminal, unsigned char byte)
+{
+	if (terminal->state == PARSER_ESCAPE)
+	{
+		if (byte == '[')
+		{
+			terminal->state = PARSER_CONTROL_SEQUENCE;
+			terminal->private_marker = false;
+			terminal->parameters_length = 0;
+			return;
+		}
+
+		terminal->state = PARSER_GROUND;
+		terminal->stats.escapes++;
+
+		if (byte == 'c')
+			reset_state(terminal);
+		else if (byte == 'D')
+			line_feed(terminal);
+		else if (byte == 'M' && terminal->cursor_row == terminal->scroll_top)
+			scroll_rows(terminal, terminal->scroll_top, terminal->scroll_bottom, -1);
+		else if (byte == 'M' && terminal->cursor_row > 0)
+			terminal->cursor_row--;
+
+		return;
+	}
+
+	if (terminal->state == PARSER_CONTROL_SEQUENCE)
+	{
+		if (byte == '?')
+		{
+			terminal->private_marker = true;
+		}
+		else if (byte >= '0' && byte <= '9')
+		{
+			if (terminal->parameters_length == 0)
+				terminal->parameters[terminal->parameters_length++] = 0;
+
+			unsigned int* parameter = &terminal->parameters[terminal->parameters_length - 1];
+			*parameter = *parameter * 10 + (byte - '0');
+		}
+		else if (byte == ';')
+		{
+			if (terminal->parameters_length == 0)
+				terminal->parameters[terminal->parameters_length++] = 0;
+
+			if (terminal->parameters_length < OOLONG_VIRTUAL_TERMINAL_MAX_PARAMETERS)
+				terminal->parameters[terminal->parameters_length++] = 0;
+		}
+		else if (byte >= 0x40 && byte <= 0x7E)
+		{
+			terminal->state = PARSER_GROUND;
+			dispatch_control_sequence(terminal, byte);
+		}
+
+		return;
+	}
+
+	/* 
+	 * UTF-8 decoding, malformed input is replaced with U+FFFD rather than being
+	 * dropped so that it still shows up in the grid.
+	 */
+
+	if (terminal->continuation_bytes > 0)
+	{
+		if ((byte & 0xC0) == 0x80)
+		{
+			terminal->code_point = (terminal->code_point << 6) | (byte & 0x3F);
+
+			if (--terminal->continuation_bytes == 0)
+				put_character(terminal, terminal->code_point);
+
+			return;
+		}
+
+		terminal->continuation_bytes = 0;
+		put_character(terminal, 0xFFFD);
+	}
+
+	if (byte == ESCAPE)
+		terminal->state = PARSER_ESCAPE;
+	else if (byte < 0x20 || byte == 0x7F)
+		control_character(terminal, byte);
+	else if (byte < 0x80)
+		put_character(terminal, byte);
+	else if ((byte & 0xE0) == 0xC0)
+		terminal->code_point = byte & 0x1F, terminal->continuation_bytes = 1;
+	else if ((byte & 0xF0) == 0xE0)
+		terminal->code_point = byte & 0x0F, terminal->continuation_bytes = 2;
+	else if ((byte & 0xF8) == 0xF0)
+		terminal->code_point = byte & 0x07, terminal->continuation_bytes = 3;
+	else
+		put_character(terminal, 0xFFFD);
+}
+
+/*
+ * Parses everything written to the terminal's file since it was last synced.
+ * The file is a temporary one rather than a wide memory stream so that what
+ * is written to it, wide or not, is encoded into the bytes a real terminal
+ * would receive, which are what is parsed and counted. Once read it is
+ * truncated so it never grows past a frame's worth of output.
+ */
+static void sync_file(oolong_virtual_terminal_t* terminal)
+{
+	fflush(terminal->file);
+
+	int descriptor = fileno(terminal->file);
+	long length = ftell(terminal->file);
+	char bytes[READ_CHUNK];
+
+	for (long offset = 0; offset < length;)
+	{
+		ssize_t read_length = pread(descriptor, bytes, sizeof bytes, offset);
+
+		if (read_length <= 0)
+			break;
+
+		oolong_virtual_terminal_write(terminal, bytes, read_length);
+		offset += read_length;
+	}
+
+	rewind(terminal->file);
+
+	if (ftruncate(descriptor, 0) != 0)
+		oolong_error_record(OOLONG_ERROR_FAILED_IO_WRITE);
+}
+
+oolong_virtual_terminal_t* oolong_virtual_terminal_create(unsigned int columns, unsigned int rows)
+{
+	if (columns < 1 || rows < 1)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return NULL;
+	}
+
+	oolong_virtual_terminal_t* terminal = oolong_memory_allocate_zeroed(1, sizeof *terminal);
+
+	if (terminal == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+		return NULL;
+	}
+
+	terminal->columns = columns;
+	terminal->rows = rows;
+	terminal->cells = oolong_memory_allocate_zeroed((size_t)columns * rows, sizeof *terminal->cells);
+	terminal->file = tmpfile();
+
+	if (terminal->cells == NULL || terminal->file == NULL)
+	{
+		oolong_error_record(terminal->cells == NULL ? OOLONG_ERROR_NOT_ENOUGH_MEMORY : OOLONG_ERROR_FAILED_IO_WRITE);
+
+		if (terminal->file != NULL)
+			fclose(terminal->file);
+
+		oolong_memory_free(terminal->cells);
+		oolong_memory_free(terminal);
+		return NULL;
+	}
+
+	reset_state(terminal);
+	return terminal;
+}
+
+oolong_error_t oolong_virtual_terminal_destroy(oolong_virtual_terminal_t* terminal)
+{
+	if (terminal == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	fclose(terminal->file);
+	oolong_memory_free(terminal->cells);
+	oolong_memory_free(terminal);
+	return OOLONG_ERROR_NONE;
+}
+
+FILE* oolong_virtual_terminal_get_file(oolong_virtual_terminal_t* terminal)
+{
+	if (terminal == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return NULL;
+	}
+
+	return terminal->file;
+}
+
+oolong_error_t oolong_virtual_terminal_write(oolong_virtual_terminal_t* terminal, const char* bytes, size_t length)
+{
+	if (terminal == NULL || (bytes == NULL && length > 0))
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	terminal->stats.bytes += length;
+
+	for (size_t index = 0; index < length; index++)
+		parse_byte(terminal, bytes[index]);
+
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_virtual_cell_t* oolong_virtual_terminal_get_cell(oolong_virtual_terminal_t* terminal, unsigned int column, unsigned int row)
+{
+	if (terminal == NULL || column >= terminal->columns || row >= terminal->rows)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return NULL;
+	}
+
+	sync_file(terminal);
+	return cell_at(terminal, column, row);
+}
+
+size_t oolong_virtual_terminal_read_row(oolong_virtual_terminal_t* terminal, unsigned int row, wchar_t* buffer)
+{
+	if (terminal == NULL || buffer == NULL || row >= terminal->rows)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return 0;
+	}
+
+	sync_file(terminal);
+	size_t length = 0;
+
+	for (unsigned int column = 0; column < terminal->columns; column++)
+		if (cell_at(terminal, column, row)->character != L'\0')
+			buffer[length++] = cell_at(terminal, column, row)->character;
+
+	buffer[length] = L'\0';
+	return length;
+}
+
+oolong_error_t oolong_virtual_terminal_get_cursor(oolong_virtual_terminal_t* terminal, unsigned int* column, unsigned int* row)
+{
+	if (terminal == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	sync_file(terminal);
+
+	if (column != NULL)
+		*column = terminal->cursor_column;
+
+	if (row != NULL)
+		*row = terminal->cursor_row;
+
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_virtual_terminal_stats_t oolong_virtual_terminal_get_stats(oolong_virtual_terminal_t* terminal)
+{
+	if (terminal == NULL)
+	{
+		oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+		return (oolong_virtual_terminal_stats_t){ 0 };
+	}
+
+	sync_file(terminal);
+	return terminal->stats;
+}
+
+oolong_error_t oolong_virtual_terminal_reset_stats(oolong_virtual_terminal_t* terminal)
+{
+	if (terminal == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	sync_file(terminal);
+	terminal->stats = (oolong_virtual_terminal_stats_t){ 0 };
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_virtual_terminal_reset(oolong_virtual_terminal_t* terminal)
+{
+	if (terminal == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	/* Pending output is dropped rather than parsed. */
+	fflush(terminal->file);
+	rewind(terminal->file);
+
+	if (ftruncate(fileno(terminal->file), 0) != 0)
+		return oolong_error_record(OOLONG_ERROR_FAILED_IO_WRITE);
+
+	reset_state(terminal);
+	terminal->state = PARSER_GROUND;
+	terminal->continuation_bytes = 0;
+	return OOLONG_ERROR_NONE;
+}
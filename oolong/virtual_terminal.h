@@ -0,0 +1,120 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_VIRTUAL_TERMINAL_H
+#define OOLONG_VIRTUAL_TERMINAL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <wchar.h>
+#include "error.h"
+
+/* Number of numeric parameters kept for a single control sequence. */
+#define OOLONG_VIRTUAL_TERMINAL_MAX_PARAMETERS 16
+
+enum oolong_virtual_attribute_e
+{
+	OOLONG_VIRTUAL_ATTRIBUTE_BOLD		= 0b0001,
+	OOLONG_VIRTUAL_ATTRIBUTE_ITALIC		= 0b0010,
+	OOLONG_VIRTUAL_ATTRIBUTE_UNDERLINE	= 0b0100
+};
+
+typedef enum oolong_virtual_attribute_e oolong_virtual_attribute_t;
+typedef struct oolong_virtual_cell_s oolong_virtual_cell_t;
+typedef struct oolong_virtual_terminal_stats_s oolong_virtual_terminal_stats_t;
+typedef struct oolong_virtual_terminal_s oolong_virtual_terminal_t;
+
+struct oolong_virtual_cell_s
+{
+	wchar_t character;		/* The cell's character, a space when blank and L'\0' right of a wide character. */
+	uint8_t attributes;		/* Bitwise or of oolong_virtual_attribute_t values. */
+	int8_t foreground;		/* Colour 0 through 7 as in SGR 30 through 37, -1 for the default colour. */
+	int8_t background;		/* Colour 0 through 7 as in SGR 40 through 47, -1 for the default colour. */
+};
+
+/*
+ * Counters of everything the virtual terminal has been sent since it was
+ * created or its statistics were last reset.
+ */
+struct oolong_virtual_terminal_stats_s
+{
+	size_t bytes;				/* Bytes received. */
+	size_t characters;			/* Printable characters received. */
+	size_t escapes;				/* Escape and control sequences received. */
+	size_t cells_touched;		/* Cells written to or erased, counting a cell each time it is touched. */
+	size_t lines_scrolled;		/* Lines moved by scrolling, inserting, or deleting lines. */
+};
+
+/*
+ * Creates an in memory terminal of the given size. It understands the output
+ * oolong produces, that being UTF-8 text, newlines and carriage returns, cursor
+ * positioning and movement, SGR styles, erasing the screen and lines, scroll
+ * regions, scrolling, and inserting and deleting lines, and keeps the result
+ * as a grid of cells. A newline also returns the cursor to the first column,
+ * as a real terminal's output processing would. Sequences it does not know
+ * are counted and otherwise ignored.
+ *
+ * This makes rendering testable and measurable without a real terminal, to
+ * render a view to it pin the screen dimensions to the same size with
+ * oolong_set_screen_dimensions() and print to its file.
+ */
+oolong_virtual_terminal_t* oolong_virtual_terminal_create(unsigned int columns, unsigned int rows);
+
+/*
+ * Frees all memory used by the virtual terminal and closes its file.
+ */
+oolong_error_t oolong_virtual_terminal_destroy(oolong_virtual_terminal_t* terminal);
+
+/*
+ * Gets a file that writes into the virtual terminal. What is written is only
+ * parsed once a function here reads the terminal's state. Wide
+ * characters written to it are converted using the current locale, which
+ * should be a UTF-8 one.
+ */
+FILE* oolong_virtual_terminal_get_file(oolong_virtual_terminal_t* terminal);
+
+/*
+ * Sends the given UTF-8 bytes to the virtual terminal directly. Anything
+ * still buffered in the terminal's file is not read first.
+ */
+oolong_error_t oolong_virtual_terminal_write(oolong_virtual_terminal_t* terminal, const char* bytes, size_t length);
+
+/*
+ * Gets the cell at the given zero based column and row, returns NULL if it is
+ * out of bounds.
+ */
+oolong_virtual_cell_t* oolong_virtual_terminal_get_cell(oolong_virtual_terminal_t* terminal, unsigned int column, unsigned int row);
+
+/*
+ * Copies the characters of the given row into the buffer, which must have room
+ * for at least the number of columns plus one. The right halves of wide
+ * characters are skipped and the result is NUL terminated. Returns the number
+ * of characters copied.
+ */
+size_t oolong_virtual_terminal_read_row(oolong_virtual_terminal_t* terminal, unsigned int row, wchar_t* buffer);
+
+/*
+ * Gets the cursor's zero based column and row, passing NULL discards that part
+ * of the result.
+ */
+oolong_error_t oolong_virtual_terminal_get_cursor(oolong_virtual_terminal_t* terminal, unsigned int* column, unsigned int* row);
+
+/*
+ * Gets the terminal's counters.
+ */
+oolong_virtual_terminal_stats_t oolong_virtual_terminal_get_stats(oolong_virtual_terminal_t* terminal);
+
+/*
+ * Sets all of the terminal's counters back to zero, its contents are kept.
+ */
+oolong_error_t oolong_virtual_terminal_reset_stats(oolong_virtual_terminal_t* terminal);
+
+/*
+ * Blanks every cell and moves the cursor home without counting any of it,
+ * anything written to the file and not yet read is discarded.
+ */
+oolong_error_t oolong_virtual_terminal_reset(oolong_virtual_terminal_t* terminal);
+
+#endif // OOLONG_VIRTUAL_TERMINAL_H
@@ -0,0 +1,202 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "grapheme.h"
+#include "width.h"
+
+/* Number of characters checked at once by the ASCII fast path. */
+#define VECTOR_LANES 8
+
+#define ZERO_WIDTH_JOINER 0x200D
+#define VARIATION_SELECTOR_EMOJI 0xFE0F
+
+typedef uint32_t wide_vector_t __attribute__((vector_size(VECTOR_LANES * sizeof(uint32_t))));
+typedef struct width_range_s width_range_t;
+
+struct width_range_s
+{
+	uint32_t first;
+	uint32_t last;
+	uint32_t width;
+};
+
+/*
+ * Every range of characters whose width is not one, sorted so that it can be
+ * binary searched. This follows the zero width and East Asian wide ranges of
+ * Unicode 15 closely enough for terminal layout without carrying the full
+ * character database around.
+ */
+
+static const width_range_t width_ranges[] =
+{
+	{ 0x00AD,  0x00AD,  0 }, { 0x0300,  0x036F,  0 }, { 0x0483,  0x0489,  0 },
+	{ 0x0591,  0x05BD,  0 }, { 0x05BF,  0x05BF,  0 }, { 0x05C1,  0x05C2,  0 },
+	{ 0x05C4,  0x05C5,  0 }, { 0x05C7,  0x05C7,  0 }, { 0x0610,  0x061A,  0 },
+	{ 0x064B,  0x065F,  0 }, { 0x0670,  0x0670,  0 }, { 0x06D6,  0x06DC,  0 },
+	{ 0x06DF,  0x06E4,  0 }, { 0x06E7,  0x06E8,  0 }, { 0x06EA,  0x06ED,  0 },
+	{ 0x0711,  0x0711,  0 }, { 0x0730,  0x074A,  0 }, { 0x07A6,  0x07B0,  0 },
+	{ 0x07EB,  0x07F3,  0 }, { 0x0816,  0x082D,  0 }, { 0x0859,  0x085B,  0 },
+	{ 0x08D3,  0x0902,  0 }, { 0x093A,  0x093A,  0 }, { 0x093C,  0x093C,  0 },
+	{ 0x0941,  0x0948,  0 }, { 0x094D,  0x094D,  0 }, { 0x0951,  0x0957,  0 },
+	{ 0x0962,  0x0963,  0 }, { 0x0981,  0x0981,  0 }, { 0x09BC,  0x09BC,  0 },
+	{ 0x09C1,  0x09C4,  0 }, { 0x09CD,  0x09CD,  0 }, { 0x09E2,  0x09E3,  0 },
+	{ 0x0A01,  0x0A02,  0 }, { 0x0A3C,  0x0A3C,  0 }, { 0x0A41,  0x0A51,  0 },
+	{ 0x0A70,  0x0A71,  0 }, { 0x0A75,  0x0A75,  0 }, { 0x0A81,  0x0A82,  0 },
+	{ 0x0ABC,  0x0ABC,  0 }, { 0x0AC1,  0x0AC8,  0 }, { 0x0ACD,  0x0ACD,  0 },
+	{ 0x0B01,  0x0B01,  0 }, { 0x0B3C,  0x0B3C,  0 }, { 0x0B41,  0x0B44,  0 },
+	{ 0x0B4D,  0x0B4D,  0 }, { 0x0BC0,  0x0BC0,  0 }, { 0x0BCD,  0x0BCD,  0 },
+	{ 0x0C3E,  0x0C40,  0 }, { 0x0C46,  0x0C56,  0 }, { 0x0CBC,  0x0CBC,  0 },
+	{ 0x0CCC,  0x0CCD,  0 }, { 0x0D41,  0x0D44,  0 }, { 0x0D4D,  0x0D4D,  0 },
+	{ 0x0DCA,  0x0DCA,  0 }, { 0x0DD2,  0x0DD6,  0 }, { 0x0E31,  0x0E31,  0 },
+	{ 0x0E34,  0x0E3A,  0 }, { 0x0E47,  0x0E4E,  0 }, { 0x0EB1,  0x0EB1,  0 },
+	{ 0x0EB4,  0x0EBC,  0 }, { 0x0EC8,  0x0ECD,  0 }, { 0x0F18,  0x0F19,  0 },
+	{ 0x0F35,  0x0F35,  0 }, { 0x0F37,  0x0F37,  0 }, { 0x0F39,  0x0F39,  0 },
+	{ 0x0F71,  0x0F7E,  0 }, { 0x0F80,  0x0F84,  0 }, { 0x0F86,  0x0F87,  0 },
+	{ 0x0F8D,  0x0FBC,  0 }, { 0x0FC6,  0x0FC6,  0 }, { 0x102D,  0x1030,  0 },
+	{ 0x1032,  0x1037,  0 }, { 0x1039,  0x103A,  0 }, { 0x1100,  0x115F,  2 },
+	{ 0x1160,  0x11FF,  0 }, { 0x135D,  0x135F,  0 }, { 0x1712,  0x1714,  0 },
+	{ 0x17B4,  0x17B5,  0 }, { 0x17B7,  0x17BD,  0 }, { 0x17C6,  0x17C6,  0 },
+	{ 0x17C9,  0x17D3,  0 }, { 0x180B,  0x180F,  0 }, { 0x1AB0,  0x1AFF,  0 },
+	{ 0x1DC0,  0x1DFF,  0 }, { 0x200B,  0x200F,  0 }, { 0x2028,  0x202E,  0 },
+	{ 0x2060,  0x206F,  0 }, { 0x20D0,  0x20FF,  0 }, { 0x231A,  0x231B,  2 },
+	{ 0x2329,  0x232A,  2 }, { 0x23E9,  0x23EC,  2 }, { 0x23F0,  0x23F0,  2 },
+	{ 0x23F3,  0x23F3,  2 }, { 0x25FD,  0x25FE,  2 }, { 0x2614,  0x2615,  2 },
+	{ 0x2648,  0x2653,  2 }, { 0x267F,  0x267F,  2 }, { 0x2693,  0x2693,  2 },
+	{ 0x26A1,  0x26A1,  2 }, { 0x26AA,  0x26AB,  2 }, { 0x26BD,  0x26BE,  2 },
+	{ 0x26C4,  0x26C5,  2 }, { 0x26CE,  0x26CE,  2 }, { 0x26D4,  0x26D4,  2 },
+	{ 0x26EA,  0x26EA,  2 }, { 0x26F2,  0x26F3,  2 }, { 0x26F5,  0x26F5,  2 },
+	{ 0x26FA,  0x26FA,  2 }, { 0x26FD,  0x26FD,  2 }, { 0x2705,  0x2705,  2 },
+	{ 0x270A,  0x270B,  2 }, { 0x2728,  0x2728,  2 }, { 0x274C,  0x274C,  2 },
+	{ 0x274E,  0x274E,  2 }, { 0x2753,  0x2755,  2 }, { 0x2757,  0x2757,  2 },
+	{ 0x2795,  0x2797,  2 }, { 0x27B0,  0x27B0,  2 }, { 0x27BF,  0x27BF,  2 },
+	{ 0x2B1B,  0x2B1C,  2 }, { 0x2B50,  0x2B50,  2 }, { 0x2B55,  0x2B55,  2 },
+	{ 0x2CEF,  0x2CF1,  0 }, { 0x2DE0,  0x2DFF,  0 }, { 0x2E80,  0x3029,  2 },
+	{ 0x302A,  0x302D,  0 }, { 0x302E,  0x303E,  2 }, { 0x3041,  0x3098,  2 },
+	{ 0x3099,  0x309A,  0 }, { 0x309B,  0x33FF,  2 }, { 0x3400,  0x4DBF,  2 },
+	{ 0x4E00,  0xA4CF,  2 }, { 0xA66F,  0xA672,  0 }, { 0xA674,  0xA67D,  0 },
+	{ 0xA69E,  0xA69F,  0 }, { 0xA6F0,  0xA6F1,  0 }, { 0xA8E0,  0xA8F1,  0 },
+	{ 0xA960,  0xA97F,  2 }, { 0xAC00,  0xD7A3,  2 }, { 0xD7B0,  0xD7FF,  0 },
+	{ 0xF900,  0xFAFF,  2 }, { 0xFB1E,  0xFB1E,  0 }, { 0xFE00,  0xFE0F,  0 },
+	{ 0xFE10,  0xFE19,  2 }, { 0xFE20,  0xFE2F,  0 }, { 0xFE30,  0xFE6F,  2 },
+	{ 0xFEFF,  0xFEFF,  0 }, { 0xFF00,  0xFF60,  2 }, { 0xFFE0,  0xFFE6,  2 },
+	{ 0xFFF9,  0xFFFB,  0 }, { 0x101FD, 0x101FD, 0 }, { 0x10A01, 0x10A0F, 0 },
+	{ 0x10A38, 0x10A3F, 0 }, { 0x11001, 0x11001, 0 }, { 0x11038, 0x11046, 0 },
+	{ 0x16FE0, 0x16FE4, 2 }, { 0x17000, 0x18CFF, 2 }, { 0x1B000, 0x1B2FF, 2 },
+	{ 0x1D167, 0x1D169, 0 }, { 0x1D173, 0x1D182, 0 }, { 0x1D185, 0x1D18B, 0 },
+	{ 0x1D1AA, 0x1D1AD, 0 }, { 0x1F004, 0x1F004, 2 }, { 0x1F0CF, 0x1F0CF, 2 },
+	{ 0x1F18E, 0x1F18E, 2 }, { 0x1F191, 0x1F19A, 2 }, { 0x1F200, 0x1F251, 2 },
+	{ 0x1F260, 0x1F265, 2 }, { 0x1F300, 0x1F320, 2 }, { 0x1F32D, 0x1F335, 2 },
+	{ 0x1F337, 0x1F37C, 2 }, { 0x1F37E, 0x1F393, 2 }, { 0x1F3A0, 0x1F3CA, 2 },
+	{ 0x1F3CF, 0x1F3D3, 2 }, { 0x1F3E0, 0x1F3F0, 2 }, { 0x1F3F4, 0x1F3F4, 2 },
+	{ 0x1F3F8, 0x1F43E, 2 }, { 0x1F440, 0x1F440, 2 }, { 0x1F442, 0x1F4FC, 2 },
+	{ 0x1F4FF, 0x1F53D, 2 }, { 0x1F54B, 0x1F54E, 2 }, { 0x1F550, 0x1F567, 2 },
+	{ 0x1F57A, 0x1F57A, 2 }, { 0x1F595, 0x1F596, 2 }, { 0x1F5A4, 0x1F5A4, 2 },
+	{ 0x1F5FB, 0x1F64F, 2 }, { 0x1F680, 0x1F6C5, 2 }, { 0x1F6CC, 0x1F6CC, 2 },
+	{ 0x1F6D0, 0x1F6D2, 2 }, { 0x1F6D5, 0x1F6D7, 2 }, { 0x1F6DC, 0x1F6DF, 2 },
+	{ 0x1F6EB, 0x1F6EC, 2 }, { 0x1F6F4, 0x1F6FC, 2 }, { 0x1F7E0, 0x1F7EB, 2 },
+	{ 0x1F7F0, 0x1F7F0, 2 }, { 0x1F90C, 0x1F93A, 2 }, { 0x1F93C, 0x1F945, 2 },
+	{ 0x1F947, 0x1F9FF, 2 }, { 0x1FA70, 0x1FAFF, 2 }, { 0x20000, 0x2FFFD, 2 },
+	{ 0x30000, 0x3FFFD, 2 }, { 0xE0001, 0xE0001, 0 }, { 0xE0020, 0xE007F, 0 },
+	{ 0xE0100, 0xE01EF, 0 },
+};
+
+#define WIDTH_RANGES_LENGTH (sizeof width_ranges / sizeof width_ranges[0])
+
+unsigned int oolong_width_of_char(wchar_t character)
+{
+	uint32_t code_point = (uint32_t)character;
+
+	if (code_point < 0x20 || (code_point >= 0x7F && code_point < 0xA0))
+		return 0;
+
+	if (code_point < width_ranges[0].first || code_point > width_ranges[WIDTH_RANGES_LENGTH - 1].last)
+		return 1;
+
+	size_t low = 0;
+	size_t high = WIDTH_RANGES_LENGTH;
+
+	while (low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+
+		if (code_point < width_ranges[middle].first)
+			high = middle;
+		else if (code_point > width_ranges[middle].last)
+			low = middle + 1;
+		else
+			return width_ranges[middle].width;
+	}
+
+	return 1;
+}
+
+/*
+ * Width of a character given the one before it, so that a string's width is
+ * the sum of its grapheme clusters' widths. A pictograph joined to the one
+ * before it by a zero width joiner draws as part of that one, and the emoji
+ * variation selector turns narrow pictographs into wide emoji.
+ */
+static unsigned int width_of_char_after(wchar_t character, wchar_t previous)
+{
+	if (previous == ZERO_WIDTH_JOINER && oolong_grapheme_is_pictographic(character))
+		return 0;
+
+	if (character == VARIATION_SELECTOR_EMOJI && oolong_grapheme_is_pictographic(previous))
+		return oolong_width_of_char(previous) == 1 ? 1 : 0;
+
+	return oolong_width_of_char(character);
+}
+
+size_t oolong_width_of_string(const wchar_t* string, size_t length)
+{
+	if (string == NULL)
+		return 0;
+
+	size_t width = 0;
+	size_t index = 0;
+	wchar_t previous = L'\0';
+
+	while (index + VECTOR_LANES <= length)
+	{
+		wide_vector_t characters;
+		memcpy(&characters, &string[index], sizeof characters);
+
+		/*
+		 * Printable ASCII is 0x20 through 0x7E, subtracting 0x20 wraps anything
+		 * below the range around to a large unsigned value so a single compare
+		 * per lane is enough. Every lane of 'printable' is all ones when true.
+		 */
+
+		wide_vector_t printable = (characters - 0x20) < 0x5F;
+		uint32_t all_printable = ~0u;
+
+		for (size_t lane = 0; lane < VECTOR_LANES; lane++)
+			all_printable &= printable[lane];
+
+		if (all_printable)
+		{
+			width += VECTOR_LANES;
+			index += VECTOR_LANES;
+			previous = string[index - 1];
+			continue;
+		}
+
+		for (size_t end = index + VECTOR_LANES; index < end; index++)
+		{
+			width += width_of_char_after(string[index], previous);
+			previous = string[index];
+		}
+	}
+
+	for (; index < length; index++)
+	{
+		width += width_of_char_after(string[index], previous);
+		previous = string[index];
+	}
+
+	return width;
+}
@@ -0,0 +1,33 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_WIDTH_H
+#define OOLONG_WIDTH_H
+
+#include <wchar.h>
+#include <stddef.h>
+
+#ifndef __GNUC__
+#warning "OOLONG: not compiling with GCC, width.h utilises GCC compiler extensions."
+#endif // __GNUC__
+
+/*
+ * Gets the number of terminal columns the given character occupies. Combining
+ * marks, zero width characters, and control characters take no columns, East
+ * Asian wide and fullwidth characters as well as most emoji take two, and
+ * everything else one. Unlike wcwidth() this never returns -1 and does not
+ * depend on the current locale.
+ */
+unsigned int oolong_width_of_char(wchar_t character);
+
+/*
+ * Gets the number of terminal columns the first 'length' characters of the
+ * given string occupy. Runs of printable ASCII are measured several characters
+ * at a time so that the common case costs little more than a wcslen(). Emoji
+ * joined by zero width joiners are measured as the single emoji they draw as.
+ */
+size_t oolong_width_of_string(const wchar_t* string, size_t length);
+
+#endif // OOLONG_WIDTH_H
@@ -0,0 +1,131 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+#include "worker_pool.h"
+
+static pthread_mutex_t run_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+
+static unsigned int workers = 0;
+static unsigned int participants = 0;
+static unsigned int running = 0;
+static unsigned long generation = 0;
+static oolong_worker_job_t current_job = NULL;
+static void* current_argument = NULL;
+static unsigned long spawn_generation[OOLONG_WORKER_POOL_MAX_THREADS];
+
+static void* worker_main(void* index_pointer)
+{
+	unsigned int index = (unsigned int)(size_t)index_pointer;
+	pthread_mutex_lock(&pool_mutex);
+	unsigned long seen_generation = spawn_generation[index];
+
+	for (;;)
+	{
+		while (generation == seen_generation)
+			pthread_cond_wait(&pool_start, &pool_mutex);
+
+		seen_generation = generation;
+
+		/* 
+		 * Workers beyond the number requested for this job sit it out but still
+		 * note its generation so they dont pick it up later.
+		 */
+
+		if (index >= participants)
+			continue;
+
+		oolong_worker_job_t job = current_job;
+		void* argument = current_argument;
+
+		pthread_mutex_unlock(&pool_mutex);
+		job(argument);
+		pthread_mutex_lock(&pool_mutex);
+
+		if (--running == 0)
+			pthread_cond_signal(&pool_done);
+	}
+
+	return NULL;
+}
+
+static oolong_error_t spawn_workers(unsigned int count)
+{
+	while (workers < count)
+	{
+		pthread_t thread;
+
+		/*
+		 * A worker spawned after other jobs have already run must start from the
+		 * current generation, otherwise it would pick up a job that is over.
+		 */
+
+		pthread_mutex_lock(&pool_mutex);
+		spawn_generation[workers] = generation;
+		int failed = pthread_create(&thread, NULL, worker_main, (void*)(size_t)workers);
+		pthread_mutex_unlock(&pool_mutex);
+
+		if (failed)
+			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+		pthread_detach(thread);
+		workers++;
+	}
+
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_worker_pool_run(unsigned int threads, oolong_worker_job_t job, void* argument)
+{
+	if (job == NULL || threads < 1)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (threads > OOLONG_WORKER_POOL_MAX_THREADS)
+		threads = OOLONG_WORKER_POOL_MAX_THREADS;
+
+	if (threads == 1)
+	{
+		job(argument);
+		return OOLONG_ERROR_NONE;
+	}
+
+	pthread_mutex_lock(&run_mutex);
+
+	if (spawn_workers(threads - 1) != OOLONG_ERROR_NONE)
+	{
+		/* Whatever workers we do have are still useful. */
+		threads = workers + 1;
+	}
+
+	pthread_mutex_lock(&pool_mutex);
+	current_job = job;
+	current_argument = argument;
+	participants = threads - 1;
+	running = threads - 1;
+	generation++;
+	pthread_cond_broadcast(&pool_start);
+	pthread_mutex_unlock(&pool_mutex);
+
+	job(argument);
+
+	pthread_mutex_lock(&pool_mutex);
+
+	while (running > 0)
+		pthread_cond_wait(&pool_done, &pool_mutex);
+
+	pthread_mutex_unlock(&pool_mutex);
+	pthread_mutex_unlock(&run_mutex);
+	return OOLONG_ERROR_NONE;
+}
+
+unsigned int oolong_worker_pool_get_processors(void)
+{
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	return processors < 1 ? 1 : (unsigned int)processors;
+}
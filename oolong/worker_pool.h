@@ -0,0 +1,35 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_WORKER_POOL_H
+#define OOLONG_WORKER_POOL_H
+
+#include "error.h"
+
+/* Most threads, including the calling thread, that will ever run a job. */
+#define OOLONG_WORKER_POOL_MAX_THREADS 64
+
+typedef void (*oolong_worker_job_t)(void* argument);
+
+/*
+ * Runs the given job on 'threads' threads at once, the calling thread being
+ * one of them, and returns once every thread has returned from the job. Worker
+ * threads are created the first time they are needed and then kept around for
+ * later jobs so that running a job every frame stays cheap.
+ *
+ * The job is given the same argument on every thread and is expected to split
+ * work up itself, for example by atomically claiming chunks of an array. Only
+ * one job runs at a time, calls from different threads wait their turn. A job
+ * must not run another job itself.
+ */
+oolong_error_t oolong_worker_pool_run(unsigned int threads, oolong_worker_job_t job, void* argument);
+
+/*
+ * Gets the number of processors currently online, or 1 if that cannot be
+ * determined. Useful for picking how many threads to run a job on.
+ */
+unsigned int oolong_worker_pool_get_processors(void);
+
+#endif // OOLONG_WORKER_POOL_H
@@ -0,0 +1,197 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stdbool.h>
+#include "memory.h"
+#include "width.h"
+#include "wrap.h"
+
+static bool is_space(const wchar_t* cluster, size_t cluster_length)
+{
+	return cluster_length == 1 && (cluster[0] == L' ' || cluster[0] == L'\t');
+}
+
+static bool is_newline(const wchar_t* cluster)
+{
+	return cluster[0] == L'\n' || cluster[0] == L'\r';
+}
+
+static oolong_error_t push_line(oolong_wrap_t* wrap, size_t start, size_t end, size_t width)
+{
+	if (wrap->count == wrap->capacity)
+	{
+		size_t capacity = wrap->capacity ? wrap->capacity * 2 : 8;
+		oolong_wrap_line_t* new_lines = oolong_memory_reallocate(wrap->lines, capacity, sizeof *wrap->lines);
+
+		if (new_lines == NULL)
+			return oolong_error_record(OOLONG_ERROR_NOT_ENOUGH_MEMORY);
+
+		wrap->lines = new_lines;
+		wrap->capacity = capacity;
+	}
+
+	wrap->lines[wrap->count] = (oolong_wrap_line_t){ .start = start, .length = end - start, .width = width };
+	wrap->count++;
+	return OOLONG_ERROR_NONE;
+}
+
+/*
+ * Finds the line beginning at the cluster with the given index and pushes it,
+ * returns the index of the cluster beginning the next line.
+ */
+static size_t wrap_line(oolong_wrap_t* wrap, oolong_graphemes_t* graphemes, size_t cluster)
+{
+	const wchar_t* text = graphemes->source;
+	size_t line_start = oolong_graphemes_get_start(graphemes, cluster);
+	size_t width = 0;
+
+	/* Where the most recent run of spaces began, and where the word after it did. */
+	bool in_spaces = false;
+	size_t spaces_start = line_start;
+	size_t spaces_start_width = 0;
+	size_t word_start_cluster = 0;
+
+	for (; cluster < graphemes->count; cluster++)
+	{
+		size_t cluster_start = oolong_graphemes_get_start(graphemes, cluster);
+		size_t cluster_length = oolong_graphemes_get_length(graphemes, cluster);
+		const wchar_t* characters = &text[cluster_start];
+
+		if (is_newline(characters))
+		{
+			push_line(wrap, line_start, in_spaces ? spaces_start : cluster_start, in_spaces ? spaces_start_width : width);
+			return cluster + 1;
+		}
+
+		bool space = is_space(characters, cluster_length);
+		size_t cluster_width = space ? 1 : oolong_width_of_string(characters, cluster_length);
+
+		if (width > 0 && width + cluster_width > wrap->columns)
+		{
+			if (space || in_spaces)
+			{
+				/* The line ends with its last word, the spaces after it are dropped. */
+				push_line(wrap, line_start, in_spaces ? spaces_start : cluster_start, in_spaces ? spaces_start_width : width);
+
+				while (cluster < graphemes->count && is_space(&text[oolong_graphemes_get_start(graphemes, cluster)], oolong_graphemes_get_length(graphemes, cluster)))
+					cluster++;
+
+				return cluster;
+			}
+
+			if (word_start_cluster > 0)
+			{
+				push_line(wrap, line_start, spaces_start, spaces_start_width);
+				return word_start_cluster;
+			}
+
+			/* A single word wider than the line can only be broken within. */
+			push_line(wrap, line_start, cluster_start, width);
+			return cluster;
+		}
+
+		if (space && !in_spaces)
+		{
+			spaces_start = cluster_start;
+			spaces_start_width = width;
+		}
+		else if (!space && in_spaces)
+		{
+			word_start_cluster = cluster;
+		}
+
+		in_spaces = space;
+		width += cluster_width;
+	}
+
+	push_line(wrap, line_start, graphemes->length, width);
+	return cluster;
+}
+
+oolong_error_t oolong_wrap_update(oolong_wrap_t* wrap, oolong_graphemes_t* graphemes, unsigned int columns)
+{
+	if (wrap == NULL || graphemes == NULL || columns < 1)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	if (wrap->source != graphemes->source || wrap->columns != columns)
+	{
+		wrap->source = graphemes->source;
+		wrap->columns = columns;
+		oolong_wrap_invalidate_from(wrap, 0);
+	}
+	else if (wrap->text_length != graphemes->length)
+	{
+		oolong_wrap_invalidate_from(wrap, wrap->text_length < graphemes->length ? wrap->text_length : graphemes->length);
+	}
+
+	wrap->text_length = graphemes->length;
+
+	if (wrap->wrapped_length == graphemes->length && wrap->count > 0)
+		return OOLONG_ERROR_NONE;
+
+	size_t cluster = oolong_graphemes_find(graphemes, wrap->wrapped_length);
+	size_t lines = wrap->count;
+
+	do
+	{
+		cluster = wrap_line(wrap, graphemes, cluster);
+
+		/* Every line pushes one line, so a count that did not grow means no memory. */
+		if (wrap->count == lines)
+			return OOLONG_ERROR_NOT_ENOUGH_MEMORY;
+
+		lines = wrap->count;
+	}
+	while (cluster < graphemes->count);
+
+	wrap->wrapped_length = graphemes->length;
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_error_t oolong_wrap_invalidate_from(oolong_wrap_t* wrap, size_t offset)
+{
+	if (wrap == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	/* Finds the number of lines starting at or before the offset. */
+	size_t low = 0;
+	size_t high = wrap->count;
+
+	while (low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+
+		if (wrap->lines[middle].start <= offset)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	/* 'low' is now one past the line containing the offset, keep two fewer. */
+	wrap->count = low < 2 ? 0 : low - 2;
+	wrap->wrapped_length = wrap->count > 0 ? wrap->lines[wrap->count].start : 0;
+	return OOLONG_ERROR_NONE;
+}
+
+oolong_wrap_line_t* oolong_wrap_get_line(oolong_wrap_t* wrap, size_t line)
+{
+	if (wrap == NULL || line >= wrap->count)
+	{
+		oolong_error_record(OOLONG_ERROR_NO_SUCH_ELEMENT);
+		return NULL;
+	}
+
+	return &wrap->lines[line];
+}
+
+oolong_error_t oolong_wrap_destroy(oolong_wrap_t* wrap)
+{
+	if (wrap == NULL)
+		return oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+
+	oolong_memory_free(wrap->lines);
+	*wrap = (oolong_wrap_t){ 0 };
+	return OOLONG_ERROR_NONE;
+}
@@ -0,0 +1,73 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef OOLONG_WRAP_H
+#define OOLONG_WRAP_H
+
+#include <wchar.h>
+#include "error.h"
+#include "grapheme.h"
+
+typedef struct oolong_wrap_s oolong_wrap_t;
+typedef struct oolong_wrap_line_s oolong_wrap_line_t;
+
+/*
+ * A single line of wrapped text. Spaces at which a line was broken belong to
+ * neither line, so a line's length does not always reach the next line's start.
+ */
+struct oolong_wrap_line_s
+{
+	size_t start;	/* Index of the line's first character in the text. */
+	size_t length;	/* Number of characters on the line. */
+	size_t width;	/* Number of columns the line occupies. */
+};
+
+/*
+ * The cached line breaks of some text wrapped to a number of columns. Lines are
+ * broken between words where possible, within a word only when it is too long
+ * for a line by itself, and always at newlines. Breaks are only computed again
+ * from the first line an edit could affect, a zero initialized struct is an
+ * empty cache.
+ */
+struct oolong_wrap_s
+{
+	const wchar_t* source;		/* Text the lines were found in. */
+	size_t text_length;			/* Length of the text when it was last wrapped. */
+	size_t wrapped_length;		/* Index up to which the text has been wrapped. */
+	unsigned int columns;		/* Number of columns the text was wrapped to. */
+	size_t count;				/* Number of lines found. */
+	size_t capacity;			/* Number of lines 'lines' has room for. */
+	oolong_wrap_line_t* lines;
+};
+
+/*
+ * Brings the wrapped lines up to date with the text of the given grapheme
+ * cache, which must itself be up to date, at the given number of columns.
+ * Nothing is done if the text, its length, and the number of columns are all
+ * the same as last time and nothing was invalidated. A different text or
+ * number of columns wraps everything again, text that was only appended to or
+ * truncated is wrapped again from the line before its last.
+ */
+oolong_error_t oolong_wrap_update(oolong_wrap_t* wrap, oolong_graphemes_t* graphemes, unsigned int columns);
+
+/*
+ * Discards the lines an edit to the text at the given index may affect, that
+ * being the line containing it and the line before, since shortening a word
+ * at the start of a line can let it fit on the one before.
+ */
+oolong_error_t oolong_wrap_invalidate_from(oolong_wrap_t* wrap, size_t offset);
+
+/*
+ * Gets the given line, returns NULL if there is no such line.
+ */
+oolong_wrap_line_t* oolong_wrap_get_line(oolong_wrap_t* wrap, size_t line);
+
+/*
+ * Frees the memory used by the cache and resets it to empty, the struct itself
+ * is not freed.
+ */
+oolong_error_t oolong_wrap_destroy(oolong_wrap_t* wrap);
+
+#endif // OOLONG_WRAP_H
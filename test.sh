@@ -3,7 +3,7 @@
 ./build.sh
 SOURCE_FILES=$(find ./tests/ -name "*.c")
 mkdir build -p
-gcc $SOURCE_FILES ./build/oolong.a -o build/test
+gcc $SOURCE_FILES ./build/oolong.a -pthread -o build/test
 ./build/test
 
 if [ "$?" != "0" ]; then
@@ -0,0 +1,109 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <string.h>
+#include <wchar.h>
+#include "arena_tests.h"
+#include "test_helpers.h"
+#include "../oolong/oolong.h"
+
+#define ARENA_TEST_ELEMENTS 1000
+
+SCRUTINY_UNIT_TEST arena_allocation_test(void)
+{
+	oolong_arena_t* arena = oolong_arena_create(1024);
+
+	/* Freed memory is reused by the next allocation of the same size class. */
+	char* first = oolong_arena_allocate(arena, 40);
+	memset(first, 'a', 40);
+	oolong_arena_free(arena, first, 40);
+	scrutiny_assert_equal_ptr(first, oolong_arena_allocate(arena, 60));
+
+	/* Growing moves to a larger class and keeps the contents. */
+	char* grown = oolong_arena_allocate(arena, 16);
+	memcpy(grown, "arena", 6);
+	grown = oolong_arena_reallocate(arena, grown, 16, 200);
+	scrutiny_assert_equal_string("arena", grown);
+
+	/* Allocations larger than a block or the largest class still work. */
+	char* large = oolong_arena_allocate(arena, 3 * OOLONG_ARENA_LARGEST_CLASS);
+	scrutiny_assert_not_equal_ptr(NULL, large);
+	memset(large, 'b', 3 * OOLONG_ARENA_LARGEST_CLASS);
+	scrutiny_assert_true(oolong_arena_get_size(arena) >= 3 * OOLONG_ARENA_LARGEST_CLASS);
+
+	oolong_arena_destroy(arena);
+}
+
+SCRUTINY_UNIT_TEST arena_elements_test(void)
+{
+	oolong_set_locale();
+
+	struct tracking_s tracking = { 0 };
+	oolong_allocator_t allocator =
+	{
+		.allocate = tracking_allocate,
+		.reallocate = tracking_reallocate,
+		.free = tracking_free,
+		.user = &tracking
+	};
+
+	oolong_memory_set_allocator(&allocator);
+
+	oolong_arena_t* arena = oolong_arena_create(0);
+	oolong_label_t* labels[ARENA_TEST_ELEMENTS + 1] = { NULL };
+	size_t allocations = oolong_memory_get_allocations();
+	size_t created = 0;
+
+	for (size_t index = 0; index < ARENA_TEST_ELEMENTS; index++)
+	{
+		oolong_label_options_t options =
+		{
+			.alignment = OOLONG_ALIGN_LEFT,
+			.content = L"in an arena"
+		};
+
+		labels[index] = oolong_label_create_in(arena, &options);
+		created += labels[index] != NULL;
+	}
+
+	scrutiny_assert_equal_size_t(ARENA_TEST_ELEMENTS, created);
+
+	/* A thousand labels take a handful of blocks rather than a thousand allocations. */
+	scrutiny_assert_true(oolong_memory_get_allocations() - allocations < ARENA_TEST_ELEMENTS / 10);
+
+	oolong_label_options_t label_options = { .alignment = OOLONG_ALIGN_LEFT, .content = L"styled" };
+	oolong_style_set_t* style = oolong_style_set_create();
+	oolong_style_set_add(&style, OOLONG_STYLE_BOLD);
+	label_options.style = style;
+
+	oolong_label_t* styled = oolong_label_create_in(arena, &label_options);
+	oolong_element_render_string((oolong_element_t*)styled);
+	scrutiny_assert_not_equal_ptr(NULL, wcsstr(oolong_element_get_string((oolong_element_t*)styled), L"styled"));
+
+	oolong_button_options_t button_options = { .alignment = OOLONG_ALIGN_CENTER, .content = L"button", .width = 20 };
+	oolong_button_t* button = oolong_button_create_in(arena, &button_options);
+	oolong_element_render_string((oolong_element_t*)button);
+
+	oolong_text_box_options_t text_box_options = { .display_text = L"", .state = OOLONG_ELEMENT_STATE_ACTIVE, .alignment = OOLONG_ALIGN_LEFT };
+	oolong_text_box_t* text_box = oolong_text_box_create_in(arena, &text_box_options);
+	oolong_text_box_insert_text(text_box, L"typed into a text box living in an arena");
+	oolong_element_render_string((oolong_element_t*)text_box);
+	scrutiny_assert_not_equal_ptr(NULL, wcsstr(oolong_element_get_string((oolong_element_t*)text_box), L"typed into a text box living in an arena"));
+
+	/* Strings outgrowing their inline room grow in the arena, so threads are not used. */
+	for (size_t index = 0; index < ARENA_TEST_ELEMENTS; index++)
+		oolong_element_set_content((oolong_element_t*)labels[index], L"in an arena, with more content than fits inline");
+
+	scrutiny_assert_equal_enum(OOLONG_ERROR_NONE, oolong_element_render_strings((oolong_element_t**)labels, 4));
+	scrutiny_assert_not_equal_ptr(NULL, wcsstr(oolong_element_get_string((oolong_element_t*)labels[ARENA_TEST_ELEMENTS - 1]), L"more content than fits inline"));
+
+	/* Elements may still be destroyed on their own, the rest go with the arena. */
+	oolong_label_destroy(labels[0]);
+	oolong_button_destroy(button);
+	oolong_arena_destroy(arena);
+
+	scrutiny_assert_equal_size_t(0, tracking.live);
+	oolong_memory_set_allocator(NULL);
+}
@@ -0,0 +1,14 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef ARENA_TESTS_H
+#define ARENA_TESTS_H
+
+#include "include/scrutiny.h"
+
+SCRUTINY_UNIT_TEST arena_allocation_test(void);
+SCRUTINY_UNIT_TEST arena_elements_test(void);
+
+#endif // ARENA_TESTS_H
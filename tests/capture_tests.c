@@ -0,0 +1,56 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <string.h>
+#include "capture_tests.h"
+#include "../oolong/oolong.h"
+
+SCRUTINY_UNIT_TEST capture_asciicast_test(void)
+{
+	oolong_set_locale();
+
+	FILE* null_file = fopen("/dev/null", "w");
+	FILE* recording = tmpfile();
+	char line[256];
+
+	scrutiny_assert_false(oolong_capture_is_active());
+	oolong_capture_start(recording, 80, 24);
+	scrutiny_assert_true(oolong_capture_is_active());
+
+	FILE* frame_file = oolong_frame_begin();
+	fputws(L"\x1b[1m\"hi\"\x1b[0m\n", frame_file);
+	oolong_frame_present(null_file);
+
+	frame_file = oolong_frame_begin();
+	fputws(L"\u4e2d\\", frame_file);
+	oolong_frame_present(null_file);
+
+	frame_file = oolong_frame_begin();
+	fputws(L"a\r\nb", frame_file);
+	oolong_frame_present(null_file);
+
+	oolong_capture_stop();
+	scrutiny_assert_false(oolong_capture_is_active());
+	rewind(recording);
+
+	fgets(line, sizeof line, recording);
+	scrutiny_assert_true(strncmp(line, "{\"version\": 2, \"width\": 80, \"height\": 24, ", 42) == 0);
+
+	/* Every frame is an output event with its control characters escaped and newlines returning the cursor. */
+	fgets(line, sizeof line, recording);
+	scrutiny_assert_true(line[0] == '[');
+	scrutiny_assert_equal_string(", \"o\", \"\\u001b[1m\\\"hi\\\"\\u001b[0m\\r\\n\"]\n", strchr(line, ','));
+
+	fgets(line, sizeof line, recording);
+	scrutiny_assert_equal_string(", \"o\", \"\xe4\xb8\xad\\\\\"]\n", strchr(line, ','));
+
+	/* A newline already after a carriage return is not given another. */
+	fgets(line, sizeof line, recording);
+	scrutiny_assert_equal_string(", \"o\", \"a\\u000d\\nb\"]\n", strchr(line, ','));
+	scrutiny_assert_true(fgets(line, sizeof line, recording) == NULL);
+
+	fclose(recording);
+	fclose(null_file);
+}
@@ -0,0 +1,13 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef CAPTURE_TESTS_H
+#define CAPTURE_TESTS_H
+
+#include "include/scrutiny.h"
+
+SCRUTINY_UNIT_TEST capture_asciicast_test(void);
+
+#endif // CAPTURE_TESTS_H
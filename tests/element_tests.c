@@ -3,8 +3,12 @@
  * See LICENSE file in repository root for complete license text.
  */
 
+#include <stdlib.h>
 #include "element_tests.h"
 #include "../oolong/element.h"
+#include "../oolong/memory.h"
+#include "../oolong/label.h"
+#include "../oolong/frame.h"
 
 #define SELECTION_TEST_ELEMENTS 6
 
@@ -94,13 +98,14 @@ SCRUTINY_UNIT_TEST element_render_test(void)
 		{
 			.padding = 2,
 			.style_normal = oolong_style_set_create(),
-			.style_selected = oolong_style_set_create(),
 			.content = L"Content",
 			.width = 20,
 			.state = OOLONG_ELEMENT_STATE_NORMAL,
 			.alignment = OOLONG_ALIGN_LEFT
 		};
 
+		oolong_element_set_style(&element, OOLONG_ELEMENT_STATE_SELECTED, oolong_style_set_create());
+
 		oolong_element_render_string(&element);
 		scrutiny_assert_equal_array(expected, element.string, sizeof(wchar_t), wcslen(expected) + 1);
 	}
@@ -112,13 +117,14 @@ SCRUTINY_UNIT_TEST element_render_test(void)
 		{
 			.padding = 2,
 			.style_normal = oolong_style_set_create(),
-			.style_selected = oolong_style_set_create(),
 			.content = L"Content",
 			.width = 20,
 			.state = OOLONG_ELEMENT_STATE_NORMAL,
 			.alignment = OOLONG_ALIGN_RIGHT
 		};
 
+		oolong_element_set_style(&element, OOLONG_ELEMENT_STATE_SELECTED, oolong_style_set_create());
+
 		oolong_element_render_string(&element);
 		scrutiny_assert_equal_array(expected, element.string, sizeof(wchar_t), wcslen(expected) + 1);
 	}
@@ -130,13 +136,14 @@ SCRUTINY_UNIT_TEST element_render_test(void)
 		{
 			.padding = 2,
 			.style_normal = oolong_style_set_create(),
-			.style_selected = oolong_style_set_create(),
 			.content = L"Content",
 			.width = 20,
 			.state = OOLONG_ELEMENT_STATE_NORMAL,
 			.alignment = OOLONG_ALIGN_CENTER
 		};
 
+		oolong_element_set_style(&element, OOLONG_ELEMENT_STATE_SELECTED, oolong_style_set_create());
+
 		oolong_element_render_string(&element);
 		scrutiny_assert_equal_array(expected, element.string, sizeof(wchar_t), wcslen(expected) + 1);
 	}
@@ -162,19 +169,21 @@ SCRUTINY_UNIT_TEST element_render_test(void)
 		{
 			.padding = 2,
 			.style_normal = style_one,
-			.style_selected = style_two,
 			.content = L"Content",
 			.width = 20,
 			.state = OOLONG_ELEMENT_STATE_NORMAL,
 			.alignment = OOLONG_ALIGN_LEFT
 		};
 
+		oolong_element_set_style(&element, OOLONG_ELEMENT_STATE_SELECTED, style_two);
+
 		oolong_element_render_string(&element);
 		scrutiny_assert_equal_array(expected_one, element.string, sizeof(wchar_t), wcslen(expected_one));
 
 		element.state = OOLONG_ELEMENT_STATE_SELECTED;
 		oolong_element_render_string(&element);
 		scrutiny_assert_equal_array(expected_two, element.string, sizeof(wchar_t), wcslen(expected_two));
+		oolong_element_destroy_caches(&element);
 	}
 }
 
@@ -230,3 +239,243 @@ SCRUTINY_UNIT_TEST element_select_previous_test(void)
 		free(elements[index]);
 }
 
+
+SCRUTINY_UNIT_TEST element_render_parallel_test(void)
+{
+	const size_t elements_length = OOLONG_ELEMENT_PARALLEL_RENDER_THRESHOLD * 4 + 3;
+	wchar_t* contents[] = { L"", L"Content", L"Some longer content", L"x" };
+	oolong_alignment_t alignments[] = { OOLONG_ALIGN_LEFT, OOLONG_ALIGN_CENTER, OOLONG_ALIGN_RIGHT };
+	oolong_style_set_t* style = oolong_style_set_create();
+
+	oolong_style_set_add(&style, OOLONG_STYLE_BOLD);
+
+	oolong_element_t* serial[elements_length + 1];
+	oolong_element_t* parallel[elements_length + 1];
+	serial[elements_length] = NULL;
+	parallel[elements_length] = NULL;
+
+	for (size_t index = 0; index < elements_length; index++)
+	{
+		serial[index] = calloc(1, sizeof(oolong_element_t));
+		serial[index]->state = OOLONG_ELEMENT_STATE_NORMAL;
+		serial[index]->style_normal = index % 2 ? style : NULL;
+		serial[index]->content = contents[index % 4];
+		serial[index]->alignment = alignments[index % 3];
+		serial[index]->padding = index % 5;
+		serial[index]->width = index % 40;
+
+		parallel[index] = malloc(sizeof(oolong_element_t));
+		*parallel[index] = *serial[index];
+	}
+
+	scrutiny_assert_equal_enum(OOLONG_ERROR_NONE, oolong_element_render_strings(serial, 1));
+	scrutiny_assert_equal_enum(OOLONG_ERROR_NONE, oolong_element_render_strings(parallel, 4));
+
+	/* Rendering again reuses each element's string. */
+	scrutiny_assert_equal_enum(OOLONG_ERROR_NONE, oolong_element_render_strings(parallel, 3));
+
+	bool all_equal = true;
+
+	for (size_t index = 0; index < elements_length; index++)
+	{
+		all_equal = all_equal && wcscmp(serial[index]->string, parallel[index]->string) == 0;
+		oolong_memory_free(serial[index]->string);
+		oolong_memory_free(parallel[index]->string);
+		free(serial[index]);
+		free(parallel[index]);
+	}
+
+	scrutiny_assert_true(all_equal);
+	oolong_style_set_destroy(style);
+}
+
+SCRUTINY_UNIT_TEST element_render_wide_test(void)
+{
+	/* Two wide characters and an e with a combining accent take five columns. */
+	wchar_t* expected = L" \u4e2d\u6587e\u0301   ";
+	oolong_element_t element =
+	{
+		.padding = 1,
+		.content = L"\u4e2d\u6587e\u0301",
+		.width = 9,
+		.state = OOLONG_ELEMENT_STATE_NORMAL,
+		.alignment = OOLONG_ALIGN_LEFT
+	};
+
+	oolong_element_render_string(&element);
+	scrutiny_assert_equal_array(expected, element.string, sizeof(wchar_t), wcslen(expected) + 1);
+	scrutiny_assert_equal_size_t(5, oolong_element_get_content_width(&element));
+	scrutiny_assert_equal_size_t(9, oolong_element_get_string_width(&element));
+
+	/* Changing the content must not reuse the old content's width. */
+	oolong_element_set_content(&element, L"abcdefghij");
+	oolong_element_render_string(&element);
+	scrutiny_assert_equal_size_t(10, oolong_element_get_content_width(&element));
+	scrutiny_assert_equal_size_t(12, oolong_element_get_string_width(&element));
+	oolong_memory_free(element.string);
+}
+
+SCRUTINY_UNIT_TEST element_content_slice_test(void)
+{
+	/* Content points into the middle of a buffer with no terminator after the slice. */
+	wchar_t buffer[] = { L'h', L'e', L'l', L'l', L'o', L' ', L'w', L'o', L'r', L'l', L'd', L'!', L'!' };
+	wchar_t* expected = L"[world]  ";
+	oolong_element_t element =
+	{
+		.width = 9,
+		.state = OOLONG_ELEMENT_STATE_NORMAL,
+		.alignment = OOLONG_ALIGN_LEFT
+	};
+
+	oolong_element_set_content_slice(&element, &buffer[6], 5);
+	buffer[5] = L'[';
+	buffer[11] = L']';
+	oolong_element_set_content_slice(&element, &buffer[5], 7);
+	oolong_element_render_string(&element);
+
+	scrutiny_assert_equal_array(expected, element.string, sizeof(wchar_t), wcslen(expected) + 1);
+	scrutiny_assert_equal_size_t(7, oolong_element_get_content_length(&element));
+	scrutiny_assert_equal_size_t(7, oolong_element_get_content_width(&element));
+	scrutiny_assert_equal_size_t(wcslen(expected), oolong_element_get_string_length(&element));
+	scrutiny_assert_equal_size_t(2, oolong_element_get_wrap(&element, 4)->count);
+
+	/* Assigning terminated content directly still has its length counted. */
+	element.content = L"terminated";
+	oolong_element_render_string(&element);
+	scrutiny_assert_equal_size_t(10, oolong_element_get_content_length(&element));
+	scrutiny_assert_equal_size_t(10, oolong_element_get_string_length(&element));
+
+	oolong_element_destroy_caches(&element);
+	oolong_memory_free(element.string);
+}
+
+SCRUTINY_UNIT_TEST element_render_reuse_test(void)
+{
+	oolong_style_set_t* style = oolong_style_set_create();
+	oolong_style_set_add(&style, OOLONG_STYLE_BOLD);
+
+	oolong_element_t element =
+	{
+		.content = L"Content",
+		.width = 12,
+		.state = OOLONG_ELEMENT_STATE_NORMAL,
+		.style_normal = style,
+		.alignment = OOLONG_ALIGN_LEFT
+	};
+
+	oolong_element_render_string(&element);
+	scrutiny_assert_false(element.reused);
+
+	/* Nothing changed, so the string is kept as is. */
+	oolong_element_render_string(&element);
+	scrutiny_assert_true(element.reused);
+
+	/* Any of what the string is rendered from changing renders it again. */
+	element.state = OOLONG_ELEMENT_STATE_SELECTED;
+	oolong_element_render_string(&element);
+	scrutiny_assert_false(element.reused);
+	scrutiny_assert_equal_size_t(12, oolong_element_get_string_length(&element));
+
+	element.width = 14;
+	oolong_element_render_string(&element);
+	scrutiny_assert_false(element.reused);
+	scrutiny_assert_equal_size_t(14, oolong_element_get_string_length(&element));
+
+	oolong_element_render_string(&element);
+	scrutiny_assert_true(element.reused);
+
+	oolong_element_mark_dirty(&element);
+	oolong_element_render_string(&element);
+	scrutiny_assert_false(element.reused);
+
+	/* Content rewritten in place is noticed, whether or not its length changes. */
+	wchar_t clock[16];
+	swprintf(clock, 16, L"12:00:00");
+	oolong_element_set_content(&element, clock);
+	oolong_element_render_string(&element);
+
+	swprintf(clock, 16, L"12:00:01");
+	oolong_element_render_string(&element);
+	scrutiny_assert_false(element.reused);
+	scrutiny_assert_not_equal_ptr(NULL, wcsstr(element.string, L"12:00:01"));
+
+	swprintf(clock, 16, L"12:00:01 PM");
+	scrutiny_assert_equal_size_t(11, oolong_element_get_content_width(&element));
+	oolong_element_render_string(&element);
+	scrutiny_assert_false(element.reused);
+	scrutiny_assert_not_equal_ptr(NULL, wcsstr(element.string, L"12:00:01 PM"));
+
+	oolong_element_render_string(&element);
+	scrutiny_assert_true(element.reused);
+
+	oolong_element_destroy_caches(&element);
+	oolong_memory_free(element.string);
+	oolong_style_set_destroy(style);
+}
+
+SCRUTINY_UNIT_TEST element_inline_string_test(void)
+{
+	oolong_style_set_t* style = oolong_style_set_create();
+	oolong_style_set_add(&style, OOLONG_STYLE_BOLD);
+
+	oolong_label_options_t options =
+	{
+		.alignment = OOLONG_ALIGN_LEFT,
+		.style = style,
+		.content = L"Short label"
+	};
+
+	oolong_label_t* label = oolong_label_create(&options);
+	oolong_element_t* element = (oolong_element_t*)label;
+
+	/* A short label renders into the storage it was created with. */
+	size_t allocations = oolong_memory_get_allocations();
+	oolong_element_render_string(element);
+	scrutiny_assert_equal_size_t(allocations, oolong_memory_get_allocations());
+	scrutiny_assert_equal_size_t(11 + oolong_element_get_preceding_style_size(element) + oolong_element_get_following_style_size(element), oolong_element_get_string_length(element));
+
+	/* Outgrowing it moves the string to the heap. */
+	wchar_t* expected = L"A label with far more content than fits inline";
+	oolong_element_set_content(element, expected);
+	oolong_element_render_string(element);
+	scrutiny_assert_equal_size_t(allocations + 1, oolong_memory_get_allocations());
+	scrutiny_assert_equal_array(expected, &oolong_element_get_string(element)[element->content_offset], sizeof(wchar_t), wcslen(expected));
+
+	oolong_label_destroy(label);
+}
+
+SCRUTINY_UNIT_TEST element_compose_narrow_test(void)
+{
+	oolong_element_t element =
+	{
+		.padding = 2,
+		.content = L"abcdef",
+		.state = OOLONG_ELEMENT_STATE_NORMAL,
+		.alignment = OOLONG_ALIGN_LEFT
+	};
+
+	/* Columns too few for the padding either side cut it down rather than overflowing. */
+	unsigned int columns[] = { 0, 1, 4 };
+	wchar_t* expected[] = { L"", L"a", L" ab " };
+
+	oolong_element_render_string(&element);
+
+	for (size_t index = 0; index < sizeof columns / sizeof *columns; index++)
+	{
+		wchar_t* buffer = NULL;
+		size_t length = 0;
+		FILE* file = open_wmemstream(&buffer, &length);
+
+		oolong_frame_begin();
+		scrutiny_assert_equal_enum(OOLONG_ERROR_NONE, oolong_element_compose_line(&element, columns[index], 0));
+		oolong_frame_present(file);
+		fclose(file);
+
+		scrutiny_assert_equal_size_t(wcslen(expected[index]), length);
+		scrutiny_assert_equal_array(expected[index], buffer, sizeof(wchar_t), length);
+		free(buffer);
+	}
+
+	oolong_element_destroy_caches(&element);
+	oolong_memory_free(element.string);
+}
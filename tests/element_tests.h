@@ -11,6 +11,12 @@
 SCRUTINY_UNIT_TEST element_selected_index_test(void);
 SCRUTINY_UNIT_TEST element_selected_identifier_test(void);
 SCRUTINY_UNIT_TEST element_render_test(void);
+SCRUTINY_UNIT_TEST element_render_parallel_test(void);
+SCRUTINY_UNIT_TEST element_render_wide_test(void);
+SCRUTINY_UNIT_TEST element_content_slice_test(void);
+SCRUTINY_UNIT_TEST element_render_reuse_test(void);
+SCRUTINY_UNIT_TEST element_inline_string_test(void);
+SCRUTINY_UNIT_TEST element_compose_narrow_test(void);
 SCRUTINY_UNIT_TEST element_select_next_test(void);
 SCRUTINY_UNIT_TEST element_select_previous_test(void);
 
@@ -3,6 +3,7 @@
  * See LICENSE file in repository root for complete license text.
  */
 
+#include <pthread.h>
 #include "error_tests.h"
 #include "../oolong/error.h"
 
@@ -31,3 +32,51 @@ SCRUTINY_UNIT_TEST error_test(void)
     scrutiny_assert_equal_enum(oolong_error_check(OOLONG_ERROR_FAILED_IO_READ), OOLONG_ERROR_NONE);
 	oolong_error_set_exit_on_error(true);
 }
+
+SCRUTINY_UNIT_TEST error_last_record_test(void)
+{
+	oolong_error_set_exit_on_error(false);
+	oolong_error_clear_all();
+
+	scrutiny_assert_equal_enum(OOLONG_ERROR_NONE, oolong_error_get_last().error);
+
+	size_t line = __LINE__ + 1;
+	oolong_error_record(OOLONG_ERROR_NO_SUCH_ELEMENT);
+	oolong_error_record_t record = oolong_error_get_last();
+
+	scrutiny_assert_equal_enum(OOLONG_ERROR_NO_SUCH_ELEMENT, record.error);
+	scrutiny_assert_equal_string(__FILE__, (char*)record.file);
+	scrutiny_assert_equal_string((char*)__func__, (char*)record.function);
+	scrutiny_assert_equal_size_t(line, record.line);
+
+	oolong_error_clear(OOLONG_ERROR_NO_SUCH_ELEMENT);
+	scrutiny_assert_equal_enum(OOLONG_ERROR_NONE, oolong_error_get_last().error);
+	oolong_error_set_exit_on_error(true);
+}
+
+static void* record_error_thread(void* error)
+{
+	oolong_error_record(*(oolong_error_t*)error);
+	*(oolong_error_t*)error = oolong_error_get_all();
+	return NULL;
+}
+
+SCRUTINY_UNIT_TEST error_thread_local_test(void)
+{
+	oolong_error_set_exit_on_error(false);
+	oolong_error_clear_all();
+
+	pthread_t thread;
+	oolong_error_t thread_error = OOLONG_ERROR_FAILED_IO_WRITE;
+
+	oolong_error_record(OOLONG_ERROR_INVALID_ARGUMENT);
+	pthread_create(&thread, NULL, record_error_thread, &thread_error);
+	pthread_join(thread, NULL);
+
+	/* Neither thread should see the other's errors. */
+	scrutiny_assert_equal_enum(OOLONG_ERROR_FAILED_IO_WRITE, thread_error);
+	scrutiny_assert_equal_enum(OOLONG_ERROR_INVALID_ARGUMENT, oolong_error_get_all());
+
+	oolong_error_clear_all();
+	oolong_error_set_exit_on_error(true);
+}
@@ -9,6 +9,8 @@
 #include "include/scrutiny.h"
 
 SCRUTINY_UNIT_TEST error_test(void);
+SCRUTINY_UNIT_TEST error_last_record_test(void);
+SCRUTINY_UNIT_TEST error_thread_local_test(void);
 
 #endif // ERROR_TESTS_H
 
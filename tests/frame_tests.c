@@ -0,0 +1,386 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include "frame_tests.h"
+#include "test_helpers.h"
+#include "../oolong/oolong.h"
+
+static oolong_label_t* create_bold_label(wchar_t* content)
+{
+	oolong_style_set_t* style = oolong_style_set_create();
+	oolong_style_set_add(&style, OOLONG_STYLE_BOLD);
+	return create_label(content, OOLONG_ALIGN_LEFT, style);
+}
+
+SCRUTINY_UNIT_TEST frame_stats_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(40, 10);
+	oolong_frame_reset_stats();
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(40, 10);
+	oolong_label_t* labels[] = { create_bold_label(L"one"), create_bold_label(L"two"), create_bold_label(L"three") };
+
+	oolong_stack_view_t view =
+	{
+		.elements = (oolong_element_t*[]){ (oolong_element_t*)labels[0], (oolong_element_t*)labels[1], (oolong_element_t*)labels[2], NULL },
+		.alignment = OOLONG_ALIGN_CENTER
+	};
+
+	oolong_stack_view_print(&view, oolong_virtual_terminal_get_file(terminal));
+
+	oolong_frame_stats_t stats;
+	oolong_virtual_terminal_stats_t terminal_stats = oolong_virtual_terminal_get_stats(terminal);
+	scrutiny_assert_equal_enum(OOLONG_ERROR_NONE, oolong_frame_get_stats(0, &stats));
+	scrutiny_assert_equal_size_t(1, oolong_frame_get_stats_count());
+	scrutiny_assert_equal_size_t(3, stats.elements_rendered);
+	scrutiny_assert_equal_size_t(terminal_stats.bytes, stats.bytes_written);
+	scrutiny_assert_equal_size_t(terminal_stats.escapes, stats.escapes_written);
+
+	/* Short labels render into their own inline storage rather than the heap. */
+	for (size_t index = 0; index < 3; index++)
+		scrutiny_assert_equal_ptr(((oolong_element_t*)labels[index])->inline_string, oolong_element_get_string((oolong_element_t*)labels[index]));
+
+	oolong_stack_view_print(&view, oolong_virtual_terminal_get_file(terminal));
+
+	oolong_frame_stats_t next_stats;
+	oolong_frame_get_stats(0, &next_stats);
+	scrutiny_assert_equal_uint64_t(stats.frame + 1, next_stats.frame);
+
+	/* Nothing changed between the frames so every label keeps its string. */
+	scrutiny_assert_equal_size_t(0, next_stats.elements_rendered);
+	scrutiny_assert_equal_size_t(3, next_stats.elements_reused);
+
+	/* Once the frame's own buffers have grown, rendering short labels again allocates nothing. */
+	for (size_t index = 0; index < 3; index++)
+		oolong_element_set_content((oolong_element_t*)labels[index], L"four");
+
+	oolong_stack_view_print(&view, oolong_virtual_terminal_get_file(terminal));
+	oolong_frame_get_stats(0, &next_stats);
+	scrutiny_assert_equal_size_t(3, next_stats.elements_rendered);
+	scrutiny_assert_equal_size_t(0, next_stats.allocations);
+
+	for (size_t index = 0; index < 3; index++)
+		oolong_label_destroy(labels[index]);
+
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
+
+SCRUTINY_UNIT_TEST frame_history_test(void)
+{
+	oolong_frame_stats_t stats;
+	oolong_frame_reset_stats();
+	FILE* null_file = fopen("/dev/null", "w");
+	oolong_error_set_exit_on_error(false);
+
+	scrutiny_assert_equal_size_t(0, oolong_frame_get_stats_count());
+	scrutiny_assert_equal_enum(OOLONG_ERROR_INVALID_ARGUMENT, oolong_frame_get_stats(0, &stats));
+
+	/* Frames printed by hand, each with a different amount of output. */
+	for (size_t frame = 0; frame < OOLONG_FRAME_HISTORY + 8; frame++)
+	{
+		FILE* frame_file = oolong_frame_begin();
+
+		for (size_t character = 0; character < frame; character++)
+			putwc(L'x', frame_file);
+
+		oolong_frame_end_phase(OOLONG_FRAME_PHASE_COMPOSE);
+		oolong_frame_present(null_file);
+	}
+
+	scrutiny_assert_equal_size_t(OOLONG_FRAME_HISTORY, oolong_frame_get_stats_count());
+	oolong_frame_get_stats(0, &stats);
+	scrutiny_assert_equal_size_t(OOLONG_FRAME_HISTORY + 7, stats.bytes_written);
+	oolong_frame_get_stats(OOLONG_FRAME_HISTORY - 1, &stats);
+	scrutiny_assert_equal_size_t(8, stats.bytes_written);
+	scrutiny_assert_equal_enum(OOLONG_ERROR_INVALID_ARGUMENT, oolong_frame_get_stats(OOLONG_FRAME_HISTORY, &stats));
+
+	oolong_error_set_exit_on_error(true);
+	fclose(null_file);
+}
+
+SCRUTINY_UNIT_TEST frame_steady_state_allocations_test(void)
+{
+	oolong_set_locale();
+	FILE* null_file = fopen("/dev/null", "w");
+
+	oolong_text_box_options_t text_box_options =
+	{
+		.display_text = L"",
+		.state = OOLONG_ELEMENT_STATE_ACTIVE,
+		.style_normal = oolong_style_set_create(),
+		.alignment = OOLONG_ALIGN_LEFT
+	};
+
+	oolong_label_t* label = create_bold_label(L"label");
+	oolong_text_box_t* text_box = oolong_text_box_create(&text_box_options);
+
+	oolong_stack_view_t view =
+	{
+		.elements = (oolong_element_t*[]){ (oolong_element_t*)label, (oolong_element_t*)text_box, NULL },
+		.alignment = OOLONG_ALIGN_WIDTH
+	};
+
+	/* Width aligned elements change size with the screen, after growing once they have room for both. */
+	unsigned int screen_widths[] = { 40, 60, 40, 60, 50 };
+	oolong_frame_stats_t stats;
+
+	for (size_t frame = 0; frame < 5; frame++)
+	{
+		oolong_set_screen_dimensions(screen_widths[frame], 10);
+		oolong_stack_view_print(&view, null_file);
+		oolong_frame_get_stats(0, &stats);
+
+		if (frame >= 2)
+			scrutiny_assert_equal_size_t(0, stats.allocations);
+	}
+
+	/* Typing allocates until the text box has grown, deleting and retyping then allocates nothing. */
+	size_t allocations = 0;
+
+	for (size_t round = 0; round < 2; round++)
+	{
+		if (round == 1)
+			allocations = oolong_memory_get_allocations();
+
+		for (size_t key = 0; key < 20; key++)
+		{
+			oolong_text_box_register_keystroke(text_box, KEY_LOWERCASE_A + key);
+			oolong_stack_view_print(&view, null_file);
+		}
+
+		for (size_t key = 0; key < 20; key++)
+			oolong_text_box_register_keystroke(text_box, KEY_BACKSPACE);
+	}
+
+	scrutiny_assert_equal_size_t(allocations, oolong_memory_get_allocations());
+
+	oolong_label_destroy(label);
+	oolong_text_box_destroy(text_box);
+	oolong_set_screen_dimensions(0, 0);
+	fclose(null_file);
+}
+
+SCRUTINY_UNIT_TEST frame_render_direct_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(20, 6);
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(20, 6);
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+	oolong_label_t* labels[] = { create_bold_label(L"short"), create_bold_label(L"long enough to be wrapped"), create_bold_label(L"end") };
+
+	oolong_stack_view_t view =
+	{
+		.elements = (oolong_element_t*[]){ (oolong_element_t*)labels[0], (oolong_element_t*)labels[1], (oolong_element_t*)labels[2], NULL },
+		.alignment = OOLONG_ALIGN_LEFT,
+		.margin_top = 1,
+		.margin_sides = 1,
+		.render_direct = true
+	};
+
+	oolong_stack_view_print(&view, file);
+
+	wchar_t direct_rows[6][32];
+	size_t direct_lengths[6];
+
+	uint8_t direct_attributes[6][20];
+
+	for (unsigned int row = 0; row < 6; row++)
+	{
+		direct_lengths[row] = oolong_virtual_terminal_read_row(terminal, row, direct_rows[row]);
+
+		for (unsigned int column = 0; column < 20; column++)
+			direct_attributes[row][column] = oolong_virtual_terminal_get_cell(terminal, column, row)->attributes;
+	}
+
+	/* The wrapped label keeps its style on every line. */
+	scrutiny_assert_equal_uint8_t(OOLONG_VIRTUAL_ATTRIBUTE_BOLD, direct_attributes[3][1]);
+
+	/* Nothing was rendered into the labels' own strings. */
+	for (size_t index = 0; index < 3; index++)
+		scrutiny_assert_equal_ptr(NULL, oolong_element_get_string((oolong_element_t*)labels[index]));
+
+	/* Once the frame buffer has grown, rendering directly allocates nothing. */
+	oolong_frame_stats_t stats;
+	oolong_stack_view_print(&view, file);
+	oolong_frame_get_stats(0, &stats);
+	scrutiny_assert_equal_size_t(0, stats.allocations);
+	scrutiny_assert_equal_size_t(3, stats.elements_rendered);
+
+	/* Rendering into strings first puts exactly the same on screen. */
+	view.render_direct = false;
+	oolong_virtual_terminal_reset(terminal);
+	oolong_stack_view_print(&view, file);
+
+	for (unsigned int row = 0; row < 6; row++)
+	{
+		wchar_t buffer[32];
+		size_t length = oolong_virtual_terminal_read_row(terminal, row, buffer);
+		scrutiny_assert_equal_size_t(direct_lengths[row], length);
+		scrutiny_assert_equal_array(direct_rows[row], buffer, sizeof(wchar_t), length);
+
+		uint8_t attributes[20];
+
+		for (unsigned int column = 0; column < 20; column++)
+			attributes[column] = oolong_virtual_terminal_get_cell(terminal, column, row)->attributes;
+
+		scrutiny_assert_equal_array(direct_attributes[row], attributes, sizeof(uint8_t), 20);
+	}
+
+	for (size_t index = 0; index < 3; index++)
+		oolong_label_destroy(labels[index]);
+
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
+
+SCRUTINY_UNIT_TEST frame_present_rows_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(20, 8);
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(20, 8);
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+	oolong_label_t* labels[6];
+
+	for (size_t index = 0; index < 6; index++)
+		labels[index] = create_bold_label(L"row");
+
+	oolong_stack_view_t view =
+	{
+		.elements = (oolong_element_t*[]){ (oolong_element_t*)labels[0], (oolong_element_t*)labels[1], (oolong_element_t*)labels[2], (oolong_element_t*)labels[3], (oolong_element_t*)labels[4], (oolong_element_t*)labels[5], NULL },
+		.alignment = OOLONG_ALIGN_LEFT,
+		.diff_rows = true
+	};
+
+	oolong_frame_stats_t stats;
+	oolong_stack_view_print(&view, file);
+	oolong_frame_get_stats(0, &stats);
+	scrutiny_assert_equal_size_t(6, stats.rows_written);
+
+	/* Only the changed row is written again. */
+	oolong_element_set_content((oolong_element_t*)labels[3], L"changed");
+	oolong_virtual_terminal_reset_stats(terminal);
+	oolong_stack_view_print(&view, file);
+	oolong_frame_get_stats(0, &stats);
+
+	scrutiny_assert_equal_size_t(1, stats.rows_written);
+	scrutiny_assert_equal_size_t(5, stats.rows_skipped);
+	scrutiny_assert_equal_size_t(20, oolong_virtual_terminal_get_stats(terminal).cells_touched);
+
+	assert_row(terminal, 3, L"changed             ");
+	assert_row(terminal, 4, L"row                 ");
+	scrutiny_assert_equal_uint8_t(OOLONG_VIRTUAL_ATTRIBUTE_BOLD, oolong_virtual_terminal_get_cell(terminal, 0, 3)->attributes);
+
+	/* A row the last frame had and this one does not is erased. */
+	view.elements[5] = NULL;
+	oolong_stack_view_print(&view, file);
+	assert_row(terminal, 5, L"                    ");
+
+	for (size_t index = 0; index < 6; index++)
+		oolong_label_destroy(labels[index]);
+
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
+
+SCRUTINY_UNIT_TEST frame_present_rows_full_screen_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(10, 3);
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(10, 3);
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+	oolong_label_t* labels[] = { create_bold_label(L"one"), create_bold_label(L"two"), create_bold_label(L"three") };
+
+	oolong_stack_view_t view =
+	{
+		.elements = (oolong_element_t*[]){ (oolong_element_t*)labels[0], (oolong_element_t*)labels[1], (oolong_element_t*)labels[2], NULL },
+		.alignment = OOLONG_ALIGN_LEFT,
+		.diff_rows = true
+	};
+
+	/* A frame as tall as the screen is written without scrolling it. */
+	oolong_stack_view_print(&view, file);
+	assert_row(terminal, 0, L"one       ");
+	assert_row(terminal, 1, L"two       ");
+	assert_row(terminal, 2, L"three     ");
+
+	/* So later frames still find each row where they left it. */
+	oolong_element_set_content((oolong_element_t*)labels[1], L"TWO");
+	oolong_stack_view_print(&view, file);
+	assert_row(terminal, 0, L"one       ");
+	assert_row(terminal, 1, L"TWO       ");
+	assert_row(terminal, 2, L"three     ");
+
+	for (size_t index = 0; index < 3; index++)
+		oolong_label_destroy(labels[index]);
+
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
+
+SCRUTINY_UNIT_TEST frame_present_rows_scroll_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(20, 8);
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(20, 8);
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+	wchar_t* lines[] = { L"log 1", L"log 2", L"log 3", L"log 4", L"log 5", L"log 6", L"log 7" };
+	oolong_label_t* labels[6];
+
+	for (size_t index = 0; index < 6; index++)
+		labels[index] = create_bold_label(lines[index]);
+
+	oolong_stack_view_t view =
+	{
+		.elements = (oolong_element_t*[]){ (oolong_element_t*)labels[0], (oolong_element_t*)labels[1], (oolong_element_t*)labels[2], (oolong_element_t*)labels[3], (oolong_element_t*)labels[4], (oolong_element_t*)labels[5], NULL },
+		.alignment = OOLONG_ALIGN_LEFT,
+		.diff_rows = true
+	};
+
+	oolong_stack_view_print(&view, file);
+
+	/* Following a log scrolls the screen up and writes only the new line. */
+	for (size_t index = 0; index < 6; index++)
+		oolong_element_set_content((oolong_element_t*)labels[index], lines[index + 1]);
+
+	oolong_frame_stats_t stats;
+	oolong_virtual_terminal_reset_stats(terminal);
+	oolong_stack_view_print(&view, file);
+	oolong_frame_get_stats(0, &stats);
+
+	scrutiny_assert_equal_size_t(5, stats.rows_scrolled);
+	scrutiny_assert_equal_size_t(1, stats.rows_written);
+	scrutiny_assert_equal_size_t(1, oolong_virtual_terminal_get_stats(terminal).lines_scrolled);
+	assert_row(terminal, 0, L"log 2               ");
+	assert_row(terminal, 4, L"log 6               ");
+	assert_row(terminal, 5, L"log 7               ");
+	assert_row(terminal, 6, L"                    ");
+
+	/* Going back scrolls the other way. */
+	for (size_t index = 0; index < 6; index++)
+		oolong_element_set_content((oolong_element_t*)labels[index], lines[index]);
+
+	oolong_stack_view_print(&view, file);
+	oolong_frame_get_stats(0, &stats);
+
+	scrutiny_assert_equal_size_t(5, stats.rows_scrolled);
+	scrutiny_assert_equal_size_t(1, stats.rows_written);
+	assert_row(terminal, 0, L"log 1               ");
+	assert_row(terminal, 1, L"log 2               ");
+	assert_row(terminal, 5, L"log 6               ");
+	assert_row(terminal, 6, L"                    ");
+	scrutiny_assert_equal_uint8_t(OOLONG_VIRTUAL_ATTRIBUTE_BOLD, oolong_virtual_terminal_get_cell(terminal, 0, 0)->attributes);
+
+	for (size_t index = 0; index < 6; index++)
+		oolong_label_destroy(labels[index]);
+
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
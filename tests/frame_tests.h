@@ -0,0 +1,19 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef FRAME_TESTS_H
+#define FRAME_TESTS_H
+
+#include "include/scrutiny.h"
+
+SCRUTINY_UNIT_TEST frame_stats_test(void);
+SCRUTINY_UNIT_TEST frame_history_test(void);
+SCRUTINY_UNIT_TEST frame_steady_state_allocations_test(void);
+SCRUTINY_UNIT_TEST frame_render_direct_test(void);
+SCRUTINY_UNIT_TEST frame_present_rows_test(void);
+SCRUTINY_UNIT_TEST frame_present_rows_full_screen_test(void);
+SCRUTINY_UNIT_TEST frame_present_rows_scroll_test(void);
+
+#endif // FRAME_TESTS_H
@@ -0,0 +1,61 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include "grapheme_tests.h"
+#include "../oolong/grapheme.h"
+
+SCRUTINY_UNIT_TEST grapheme_boundary_test(void)
+{
+	/* An e with a combining acute accent followed by an x. */
+	wchar_t* accented = L"e\u0301x";
+	scrutiny_assert_equal_size_t(2, oolong_grapheme_next_boundary(accented, 3, 0));
+	scrutiny_assert_equal_size_t(3, oolong_grapheme_next_boundary(accented, 3, 2));
+	scrutiny_assert_equal_size_t(3, oolong_grapheme_next_boundary(accented, 3, 3));
+
+	/* Man, ZWJ, woman, ZWJ, girl makes a single family emoji. */
+	wchar_t* family = L"\U0001f468\u200d\U0001f469\u200d\U0001f467!";
+	scrutiny_assert_equal_size_t(5, oolong_grapheme_next_boundary(family, 6, 0));
+
+	/* Waving hand with a skin tone modifier. */
+	wchar_t* waving = L"\U0001f44b\U0001f3fd";
+	scrutiny_assert_equal_size_t(2, oolong_grapheme_next_boundary(waving, 2, 0));
+
+	/* Two flags, each a pair of regional indicators. */
+	wchar_t* flags = L"\U0001f1fa\U0001f1f8\U0001f1ec\U0001f1e7";
+	scrutiny_assert_equal_size_t(2, oolong_grapheme_next_boundary(flags, 4, 0));
+	scrutiny_assert_equal_size_t(4, oolong_grapheme_next_boundary(flags, 4, 2));
+
+	/* CR LF stays together but control characters never extend. */
+	scrutiny_assert_equal_size_t(2, oolong_grapheme_next_boundary(L"\r\n", 2, 0));
+	scrutiny_assert_equal_size_t(1, oolong_grapheme_next_boundary(L"\n\u0301", 2, 0));
+}
+
+SCRUTINY_UNIT_TEST grapheme_cache_test(void)
+{
+	wchar_t text[16] = L"ab\U0001f44b";
+	oolong_graphemes_t graphemes = { 0 };
+
+	oolong_graphemes_update(&graphemes, text, wcslen(text));
+	scrutiny_assert_equal_size_t(3, graphemes.count);
+	scrutiny_assert_equal_size_t(2, oolong_graphemes_get_start(&graphemes, 2));
+	scrutiny_assert_equal_size_t(3, oolong_graphemes_get_start(&graphemes, 3));
+
+	/* Appending a modifier in place must join the last cluster, not start one. */
+	wcscat(text, L"\U0001f3fdc");
+	oolong_graphemes_update(&graphemes, text, wcslen(text));
+	scrutiny_assert_equal_size_t(4, graphemes.count);
+	scrutiny_assert_equal_size_t(2, oolong_graphemes_get_length(&graphemes, 2));
+	scrutiny_assert_equal_size_t(2, oolong_graphemes_find(&graphemes, 3));
+	scrutiny_assert_equal_size_t(3, oolong_graphemes_find(&graphemes, 4));
+
+	/* Truncating drops the clusters past the new end. */
+	text[1] = L'\0';
+	oolong_graphemes_update(&graphemes, text, wcslen(text));
+	scrutiny_assert_equal_size_t(1, graphemes.count);
+	scrutiny_assert_equal_size_t(1, graphemes.length);
+
+	oolong_graphemes_destroy(&graphemes);
+	scrutiny_assert_equal_size_t(0, graphemes.count);
+}
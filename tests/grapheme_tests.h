@@ -0,0 +1,14 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef GRAPHEME_TESTS_H
+#define GRAPHEME_TESTS_H
+
+#include "include/scrutiny.h"
+
+SCRUTINY_UNIT_TEST grapheme_boundary_test(void);
+SCRUTINY_UNIT_TEST grapheme_cache_test(void);
+
+#endif // GRAPHEME_TESTS_H
@@ -0,0 +1,143 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <wchar.h>
+#include "grid_view_tests.h"
+#include "test_helpers.h"
+#include "../oolong/oolong.h"
+
+SCRUTINY_UNIT_TEST grid_view_layout_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(30, 8);
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(30, 8);
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+
+	oolong_label_t* labels[] =
+	{
+		create_label(L"fixed", OOLONG_ALIGN_LEFT, NULL),
+		create_label(L"auto", OOLONG_ALIGN_LEFT, NULL),
+		create_label(L"rest", OOLONG_ALIGN_RIGHT, NULL),
+		create_label(L"a b c d e f", OOLONG_ALIGN_LEFT, NULL),
+		create_label(L"top", OOLONG_ALIGN_LEFT, NULL),
+		create_label(L"bottom", OOLONG_ALIGN_LEFT, NULL),
+		create_label(L"wider", OOLONG_ALIGN_LEFT, NULL)
+	};
+
+	/* A stack view nested in a cell, centering its elements within it. */
+	oolong_stack_view_t nested =
+	{
+		.elements = (oolong_element_t*[]){ (oolong_element_t*)labels[4], (oolong_element_t*)labels[5], NULL },
+		.alignment = OOLONG_ALIGN_CENTER
+	};
+
+	oolong_grid_view_options_t options =
+	{
+		.columns = (oolong_grid_column_t[])
+		{
+			{ .sizing = OOLONG_GRID_SIZE_FIXED, .size = 6 },
+			{ .sizing = OOLONG_GRID_SIZE_AUTO },
+			{ .sizing = OOLONG_GRID_SIZE_FRACTION, .size = 1 }
+		},
+		.column_count = 3,
+		.row_count = 2,
+		.margin_sides = 1,
+		.column_gap = 1
+	};
+
+	oolong_grid_view_t* grid = oolong_grid_view_create(&options);
+	oolong_grid_view_set_cell(grid, 0, 0, (oolong_grid_cell_t){ .element = (oolong_element_t*)labels[0] });
+	oolong_grid_view_set_cell(grid, 1, 0, (oolong_grid_cell_t){ .element = (oolong_element_t*)labels[1] });
+	oolong_grid_view_set_cell(grid, 2, 0, (oolong_grid_cell_t){ .element = (oolong_element_t*)labels[2] });
+	oolong_grid_view_set_cell(grid, 0, 1, (oolong_grid_cell_t){ .element = (oolong_element_t*)labels[3] });
+	oolong_grid_view_set_cell(grid, 1, 1, (oolong_grid_cell_t){ .view = &nested });
+	oolong_grid_view_set_cell(grid, 2, 1, (oolong_grid_cell_t){ .element = (oolong_element_t*)labels[6] });
+
+	scrutiny_assert_equal_enum(OOLONG_ERROR_NONE, oolong_grid_view_print(grid, file));
+
+	/* The auto column fits "bottom", the fractional one takes the rest of the 26 columns. */
+	scrutiny_assert_equal_unsigned_int(6, oolong_grid_view_get_column_width(grid, 0));
+	scrutiny_assert_equal_unsigned_int(6, oolong_grid_view_get_column_width(grid, 1));
+	scrutiny_assert_equal_unsigned_int(14, oolong_grid_view_get_column_width(grid, 2));
+
+	assert_row(terminal, 0, L" fixed  auto   rest           ");
+	assert_row(terminal, 1, L" a b c   top   wider          ");
+	assert_row(terminal, 2, L" d e f  bottom                ");
+	assert_row(terminal, 3, L"                              ");
+
+	/* Fractional columns follow the screen's width. */
+	oolong_set_screen_dimensions(40, 8);
+	oolong_virtual_terminal_reset(terminal);
+	oolong_grid_view_print(grid, file);
+	scrutiny_assert_equal_unsigned_int(24, oolong_grid_view_get_column_width(grid, 2));
+
+	oolong_grid_view_destroy(grid);
+
+	for (size_t index = 0; index < sizeof labels / sizeof *labels; index++)
+		oolong_label_destroy(labels[index]);
+
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
+
+SCRUTINY_UNIT_TEST grid_view_incremental_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(80, 24);
+
+	FILE* null_file = fopen("/dev/null", "w");
+	oolong_label_t* labels[12];
+
+	oolong_grid_view_options_t options =
+	{
+		.columns = (oolong_grid_column_t[])
+		{
+			{ .sizing = OOLONG_GRID_SIZE_AUTO },
+			{ .sizing = OOLONG_GRID_SIZE_AUTO },
+			{ .sizing = OOLONG_GRID_SIZE_FRACTION, .size = 1 }
+		},
+		.column_count = 3,
+		.row_count = 4,
+		.column_gap = 2
+	};
+
+	oolong_grid_view_t* grid = oolong_grid_view_create(&options);
+
+	for (size_t index = 0; index < 12; index++)
+	{
+		labels[index] = create_label(L"cell", OOLONG_ALIGN_LEFT, NULL);
+		oolong_grid_view_set_cell(grid, index % 3, index / 3, (oolong_grid_cell_t){ .element = (oolong_element_t*)labels[index] });
+	}
+
+	oolong_grid_view_print(grid, null_file);
+	scrutiny_assert_equal_size_t(12, oolong_grid_view_get_cells_measured(grid));
+	scrutiny_assert_equal_unsigned_int(4, oolong_grid_view_get_column_width(grid, 0));
+
+	/* Nothing changed, so nothing is measured again. */
+	oolong_grid_view_print(grid, null_file);
+	scrutiny_assert_equal_size_t(0, oolong_grid_view_get_cells_measured(grid));
+
+	/* Changing one cell only measures that cell. */
+	oolong_element_set_content((oolong_element_t*)labels[3], L"a wider cell");
+	oolong_grid_view_print(grid, null_file);
+	scrutiny_assert_equal_size_t(1, oolong_grid_view_get_cells_measured(grid));
+	scrutiny_assert_equal_unsigned_int(12, oolong_grid_view_get_column_width(grid, 0));
+	scrutiny_assert_equal_unsigned_int(4, oolong_grid_view_get_column_width(grid, 1));
+	scrutiny_assert_equal_unsigned_int(80 - 12 - 4 - 4, oolong_grid_view_get_column_width(grid, 2));
+
+	oolong_frame_stats_t stats;
+	oolong_frame_get_stats(0, &stats);
+	scrutiny_assert_equal_size_t(1, stats.elements_rendered);
+	scrutiny_assert_equal_size_t(11, stats.elements_reused);
+
+	oolong_grid_view_destroy(grid);
+
+	for (size_t index = 0; index < 12; index++)
+		oolong_label_destroy(labels[index]);
+
+	fclose(null_file);
+	oolong_set_screen_dimensions(0, 0);
+}
@@ -0,0 +1,14 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef GRID_VIEW_TESTS_H
+#define GRID_VIEW_TESTS_H
+
+#include "include/scrutiny.h"
+
+SCRUTINY_UNIT_TEST grid_view_layout_test(void);
+SCRUTINY_UNIT_TEST grid_view_incremental_test(void);
+
+#endif // GRID_VIEW_TESTS_H
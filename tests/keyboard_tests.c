@@ -3,6 +3,8 @@
  * See LICENSE file in repository root for complete license text.
  */
 
+#include <unistd.h>
+#include <time.h>
 #include "keyboard_tests.h"
 
 SCRUTINY_UNIT_TEST buffered_keys_test(void)
@@ -23,3 +25,51 @@ SCRUTINY_UNIT_TEST buffered_keys_test(void)
 		scrutiny_assert_equal_enum(keys[i], oolong_keyboard_get_key());
 }
 
+SCRUTINY_UNIT_TEST keyboard_record_replay_test(void)
+{
+	int pipe_descriptors[2];
+	int original_input = dup(STDIN_FILENO);
+	FILE* recording = tmpfile();
+
+	/* Keys are typed into a pipe standing in for stdin. */
+	pipe(pipe_descriptors);
+	dup2(pipe_descriptors[0], STDIN_FILENO);
+	oolong_keyboard_record_start(recording);
+
+	write(pipe_descriptors[1], "\e[A", 3);
+	scrutiny_assert_equal_enum(KEY_UP, oolong_keyboard_get_key());
+	nanosleep(&(struct timespec){ .tv_nsec = 20000000 }, NULL);
+	write(pipe_descriptors[1], "x", 1);
+	scrutiny_assert_equal_enum(KEY_LOWERCASE_X, oolong_keyboard_get_key());
+
+	oolong_keyboard_record_stop();
+	dup2(original_input, STDIN_FILENO);
+
+	/* Magic and version, then each read's delay and length as varints followed by its bytes. */
+	scrutiny_assert_equal_int(9 + (1 + 1 + 3) + (3 + 1 + 1), ftell(recording));
+
+	/* Replaying goes through the same decoding, with the recorded gap between keys. */
+	rewind(recording);
+	oolong_keyboard_replay_start(recording, OOLONG_REPLAY_RECORDED_SPEED);
+	struct timespec start_time, end_time;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+	scrutiny_assert_equal_enum(KEY_UP, oolong_keyboard_get_key());
+	scrutiny_assert_equal_enum(KEY_LOWERCASE_X, oolong_keyboard_get_key());
+	clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+	long elapsed_milliseconds = (end_time.tv_sec - start_time.tv_sec) * 1000 + (end_time.tv_nsec - start_time.tv_nsec) / 1000000;
+	scrutiny_assert_true(elapsed_milliseconds >= 15);
+	scrutiny_assert_true(oolong_keyboard_is_replaying());
+
+	/* Once the recording is used up the replay ends, here with stdin back at the empty pipe. */
+	dup2(pipe_descriptors[0], STDIN_FILENO);
+	close(pipe_descriptors[1]);
+	oolong_keyboard_get_key();
+	scrutiny_assert_false(oolong_keyboard_is_replaying());
+
+	dup2(original_input, STDIN_FILENO);
+	close(original_input);
+	close(pipe_descriptors[0]);
+	fclose(recording);
+}
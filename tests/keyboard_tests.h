@@ -10,6 +10,7 @@
 #include "../oolong/oolong.h"
 
 SCRUTINY_UNIT_TEST buffered_keys_test(void);
+SCRUTINY_UNIT_TEST keyboard_record_replay_test(void);
 
 #endif // KEYBOARD_TESTS_H
 
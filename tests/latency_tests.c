@@ -0,0 +1,66 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include "latency_tests.h"
+#include "../oolong/oolong.h"
+
+SCRUTINY_UNIT_TEST latency_percentile_test(void)
+{
+	oolong_latency_reset();
+	scrutiny_assert_equal_uint64_t(0, oolong_latency_get_percentile(50));
+
+	/* One through a thousand microseconds. */
+	for (uint64_t microseconds = 1; microseconds <= 1000; microseconds++)
+		oolong_latency_record(microseconds * 1000);
+
+	uint64_t median = oolong_latency_get_percentile(50);
+	uint64_t p99 = oolong_latency_get_percentile(99);
+	uint64_t maximum = oolong_latency_get_percentile(100);
+
+	/* Buckets are within a sixteenth of their true value and report their highest value. */
+	scrutiny_assert_equal_uint64_t(1000, oolong_latency_get_count());
+	scrutiny_assert_true(median >= 500000 && median <= 500000 + 500000 / 16);
+	scrutiny_assert_true(p99 >= 990000 && p99 <= 990000 + 990000 / 16);
+	scrutiny_assert_true(maximum >= 1000000 && maximum <= 1000000 + 1000000 / 16);
+
+	/* Small values are exact. */
+	oolong_latency_reset();
+	oolong_latency_record(7);
+	scrutiny_assert_equal_uint64_t(7, oolong_latency_get_percentile(100));
+
+	oolong_latency_reset();
+}
+
+SCRUTINY_UNIT_TEST latency_input_to_frame_test(void)
+{
+	oolong_latency_reset();
+
+	FILE* null_file = fopen("/dev/null", "w");
+	oolong_key_t keys[] = { KEY_LOWERCASE_A, KEY_LOWERCASE_B };
+	oolong_keyboard_buffer_keys(keys, 2);
+
+	/* Both keys arrive before the frame, only the first is measured from. */
+	oolong_keyboard_get_key();
+	oolong_keyboard_get_key();
+
+	oolong_frame_begin();
+	oolong_frame_present(null_file);
+
+	oolong_frame_stats_t stats;
+	oolong_frame_get_stats(0, &stats);
+	scrutiny_assert_equal_uint64_t(1, oolong_latency_get_count());
+	scrutiny_assert_true(stats.input_latency > 0);
+	scrutiny_assert_true(oolong_latency_get_percentile(100) >= stats.input_latency);
+
+	/* A frame without input records nothing. */
+	oolong_frame_begin();
+	oolong_frame_present(null_file);
+	oolong_frame_get_stats(0, &stats);
+	scrutiny_assert_equal_uint64_t(1, oolong_latency_get_count());
+	scrutiny_assert_equal_uint64_t(0, stats.input_latency);
+
+	fclose(null_file);
+	oolong_latency_reset();
+}
@@ -0,0 +1,14 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef LATENCY_TESTS_H
+#define LATENCY_TESTS_H
+
+#include "include/scrutiny.h"
+
+SCRUTINY_UNIT_TEST latency_percentile_test(void);
+SCRUTINY_UNIT_TEST latency_input_to_frame_test(void);
+
+#endif // LATENCY_TESTS_H
@@ -0,0 +1,437 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <wchar.h>
+#include "layout_tests.h"
+#include "test_helpers.h"
+#include "../oolong/oolong.h"
+
+static oolong_layout_node_t* create_leaf(oolong_label_t* label, oolong_alignment_t alignment)
+{
+	oolong_layout_node_options_t options =
+	{
+		.element = (oolong_element_t*)label,
+		.alignment = alignment
+	};
+
+	return oolong_layout_node_create(&options);
+}
+
+static void assert_box(oolong_layout_node_t* node, unsigned int column, unsigned int row, unsigned int width, unsigned int height)
+{
+	oolong_layout_box_t box = oolong_layout_node_get_box(node);
+	scrutiny_assert_equal_unsigned_int(column, box.column);
+	scrutiny_assert_equal_unsigned_int(row, box.row);
+	scrutiny_assert_equal_unsigned_int(width, box.width);
+	scrutiny_assert_equal_unsigned_int(height, box.height);
+}
+
+SCRUTINY_UNIT_TEST layout_boxes_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(30, 6);
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(30, 6);
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+
+	oolong_label_t* labels[] =
+	{
+		create_label(L"title", OOLONG_ALIGN_LEFT, NULL),
+		create_label(L"left", OOLONG_ALIGN_LEFT, NULL),
+		create_label(L"fill", OOLONG_ALIGN_LEFT, NULL),
+		create_label(L"right", OOLONG_ALIGN_LEFT, NULL),
+		create_label(L"end", OOLONG_ALIGN_LEFT, NULL)
+	};
+
+	oolong_layout_node_t* root = oolong_layout_node_create(&(oolong_layout_node_options_t){ .alignment = OOLONG_ALIGN_WIDTH, .padding = 1 });
+	oolong_layout_node_t* title = create_leaf(labels[0], OOLONG_ALIGN_CENTER);
+	oolong_layout_node_t* row = oolong_layout_node_create(&(oolong_layout_node_options_t){ .direction = OOLONG_LAYOUT_HORIZONTAL, .alignment = OOLONG_ALIGN_WIDTH, .gap = 1 });
+	oolong_layout_node_t* left = create_leaf(labels[1], OOLONG_ALIGN_LEFT);
+	oolong_layout_node_t* fill = create_leaf(labels[2], OOLONG_ALIGN_WIDTH);
+	oolong_layout_node_t* right = create_leaf(labels[3], OOLONG_ALIGN_LEFT);
+	oolong_layout_node_t* end = oolong_layout_node_create(&(oolong_layout_node_options_t){ .element = (oolong_element_t*)labels[4], .alignment = OOLONG_ALIGN_RIGHT, .margin_top = 1 });
+
+	oolong_layout_node_append(root, title);
+	oolong_layout_node_append(root, row);
+	oolong_layout_node_append(row, left);
+	oolong_layout_node_append(row, fill);
+	oolong_layout_node_append(row, right);
+	oolong_layout_node_append(root, end);
+
+	scrutiny_assert_equal_enum(OOLONG_ERROR_NONE, oolong_layout_print(root, file));
+
+	/* The filling leaf takes the 13 columns the rest of its row leaves spare. */
+	assert_box(root, 0, 0, 30, 4);
+	assert_box(title, 12, 0, 5, 1);
+	assert_box(row, 1, 1, 28, 1);
+	assert_box(left, 1, 1, 4, 1);
+	assert_box(fill, 6, 1, 17, 1);
+	assert_box(right, 24, 1, 5, 1);
+	assert_box(end, 26, 3, 3, 1);
+
+	assert_row(terminal, 0, L"            title             ");
+	assert_row(terminal, 1, L" left fill              right ");
+	assert_row(terminal, 2, L"                              ");
+	assert_row(terminal, 3, L"                          end ");
+
+	/* Leaves too wide for the screen are word wrapped within their box. */
+	oolong_element_set_content((oolong_element_t*)labels[0], L"a title too long to fit in one line");
+	oolong_layout_node_mark_dirty(title);
+	oolong_virtual_terminal_reset(terminal);
+	oolong_layout_print(root, file);
+
+	assert_box(title, 1, 0, 28, 2);
+	assert_box(row, 1, 2, 28, 1);
+	assert_row(terminal, 0, L" a title too long to fit in   ");
+	assert_row(terminal, 1, L" one line                     ");
+
+	oolong_layout_node_destroy(root);
+
+	for (size_t index = 0; index < sizeof labels / sizeof *labels; index++)
+		oolong_label_destroy(labels[index]);
+
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
+
+SCRUTINY_UNIT_TEST layout_incremental_test(void)
+{
+	oolong_set_locale();
+
+	oolong_label_t* labels[30];
+	oolong_layout_node_t* leaves[30];
+	oolong_layout_node_t* root = oolong_layout_node_create(&(oolong_layout_node_options_t){ .alignment = OOLONG_ALIGN_WIDTH });
+
+	for (size_t row_index = 0; row_index < 10; row_index++)
+	{
+		oolong_layout_node_t* row = oolong_layout_node_create(&(oolong_layout_node_options_t){ .direction = OOLONG_LAYOUT_HORIZONTAL, .gap = 2 });
+		oolong_layout_node_append(root, row);
+
+		for (size_t index = row_index * 3; index < row_index * 3 + 3; index++)
+		{
+			labels[index] = create_label(L"cell", OOLONG_ALIGN_LEFT, NULL);
+			leaves[index] = create_leaf(labels[index], OOLONG_ALIGN_LEFT);
+			oolong_layout_node_append(row, leaves[index]);
+		}
+	}
+
+	oolong_layout_update(root, 80, 24);
+	scrutiny_assert_equal_size_t(41, oolong_layout_get_nodes_measured(root));
+
+	/* Nothing was marked dirty, so nothing is measured again. */
+	oolong_layout_update(root, 80, 24);
+	scrutiny_assert_equal_size_t(0, oolong_layout_get_nodes_measured(root));
+
+	/*
+	 * Changing one leaf measures it, the nodes above it, and the leaves after it
+	 * in its row, whose available width depends on it.
+	 */
+	oolong_element_set_content((oolong_element_t*)labels[12], L"a wider cell");
+	oolong_layout_node_mark_dirty(leaves[12]);
+	oolong_layout_update(root, 80, 24);
+	scrutiny_assert_equal_size_t(5, oolong_layout_get_nodes_measured(root));
+
+	assert_box(leaves[12], 0, 4, 12, 1);
+	assert_box(leaves[13], 14, 4, 4, 1);
+	assert_box(leaves[16], 6, 5, 4, 1);
+
+	/* A different screen width changes what every node has available. */
+	oolong_layout_update(root, 40, 24);
+	scrutiny_assert_equal_size_t(41, oolong_layout_get_nodes_measured(root));
+
+	oolong_layout_node_destroy(root);
+
+	for (size_t index = 0; index < 30; index++)
+		oolong_label_destroy(labels[index]);
+}
+
+SCRUTINY_UNIT_TEST layout_damage_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(40, 8);
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(40, 8);
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+
+	oolong_label_t* clock = create_label(L"12:00:00", OOLONG_ALIGN_LEFT, NULL);
+	oolong_label_t* lines[] = { create_label(L"line 1", OOLONG_ALIGN_LEFT, NULL), create_label(L"line 2", OOLONG_ALIGN_LEFT, NULL), create_label(L"line 3", OOLONG_ALIGN_LEFT, NULL) };
+	oolong_layout_node_t* leaves[3];
+	oolong_layout_node_t* root = oolong_layout_node_create(&(oolong_layout_node_options_t){ .alignment = OOLONG_ALIGN_WIDTH });
+
+	oolong_layout_node_append(root, create_leaf(clock, OOLONG_ALIGN_RIGHT));
+
+	for (size_t index = 0; index < 3; index++)
+	{
+		leaves[index] = create_leaf(lines[index], OOLONG_ALIGN_LEFT);
+		oolong_layout_node_append(root, leaves[index]);
+	}
+
+	oolong_layout_print(root, file);
+	oolong_virtual_terminal_reset_stats(terminal);
+
+	/* A ticking clock only draws its own box again. */
+	oolong_element_set_content((oolong_element_t*)clock, L"12:00:01");
+	oolong_layout_print(root, file);
+
+	oolong_virtual_terminal_stats_t stats = oolong_virtual_terminal_get_stats(terminal);
+	scrutiny_assert_equal_size_t(8, stats.cells_touched);
+	assert_row(terminal, 0, L"                                12:00:01");
+	assert_row(terminal, 1, L"line 1                                  ");
+
+	/* A leaf growing damages the box it was in and the one it is in, merged into one. */
+	oolong_layout_box_t damage[4];
+	oolong_element_set_content((oolong_element_t*)lines[1], L"a much longer line 2");
+	oolong_layout_node_mark_dirty(leaves[1]);
+	oolong_layout_update(root, 40, 8);
+
+	scrutiny_assert_equal_size_t(1, oolong_layout_get_damage(root, damage, 4));
+	scrutiny_assert_equal_unsigned_int(0, damage[0].column);
+	scrutiny_assert_equal_unsigned_int(2, damage[0].row);
+	scrutiny_assert_equal_unsigned_int(20, damage[0].width);
+	scrutiny_assert_equal_unsigned_int(1, damage[0].height);
+
+	oolong_layout_print(root, file);
+	assert_row(terminal, 2, L"a much longer line 2                    ");
+	scrutiny_assert_equal_size_t(0, oolong_layout_get_damage(root, NULL, 0));
+
+	/* Removing a leaf erases what it covered. */
+	oolong_layout_node_destroy(leaves[2]);
+	oolong_layout_print(root, file);
+	assert_row(terminal, 3, L"                                        ");
+	assert_row(terminal, 2, L"a much longer line 2                    ");
+
+	oolong_layout_node_destroy(root);
+	oolong_label_destroy(clock);
+
+	for (size_t index = 0; index < 3; index++)
+		oolong_label_destroy(lines[index]);
+
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
+
+SCRUTINY_UNIT_TEST layout_offscreen_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(20, 3);
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(20, 3);
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+
+	oolong_label_t* labels[] = { create_label(L"one", OOLONG_ALIGN_LEFT, NULL), create_label(L"two", OOLONG_ALIGN_LEFT, NULL), create_label(L"three", OOLONG_ALIGN_LEFT, NULL), create_label(L"four", OOLONG_ALIGN_LEFT, NULL), create_label(L"five", OOLONG_ALIGN_LEFT, NULL) };
+	oolong_layout_node_t* leaves[5];
+	oolong_layout_node_t* root = oolong_layout_node_create(&(oolong_layout_node_options_t){ .alignment = OOLONG_ALIGN_WIDTH });
+
+	for (size_t index = 0; index < 5; index++)
+	{
+		leaves[index] = create_leaf(labels[index], OOLONG_ALIGN_LEFT);
+		oolong_layout_node_append(root, leaves[index]);
+	}
+
+	oolong_layout_print(root, file);
+	assert_row(terminal, 2, L"three               ");
+
+	/* The tree is clipped to the screen, leaving nothing visible of the leaves below it. */
+	scrutiny_assert_equal_unsigned_int(1, oolong_layout_node_get_visible_box(leaves[2]).height);
+	scrutiny_assert_equal_unsigned_int(0, oolong_layout_node_get_visible_box(leaves[3]).height);
+	scrutiny_assert_equal_unsigned_int(0, oolong_layout_node_get_visible_box(leaves[4]).height);
+
+	/* Leaves below the last row are not drawn over it, however they change. */
+	oolong_element_set_content((oolong_element_t*)labels[4], L"OFFSCREEN");
+	oolong_layout_node_mark_dirty(leaves[4]);
+	oolong_layout_print(root, file);
+
+	assert_row(terminal, 0, L"one                 ");
+	assert_row(terminal, 1, L"two                 ");
+	assert_row(terminal, 2, L"three               ");
+
+	oolong_layout_node_destroy(root);
+
+	for (size_t index = 0; index < 5; index++)
+		oolong_label_destroy(labels[index]);
+
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
+
+SCRUTINY_UNIT_TEST layout_wrapped_fill_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(12, 4);
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(12, 4);
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+
+	/* A filling leaf is measured before its element is ever rendered at its width. */
+	oolong_label_t* label = create_label(L"alpha beta gamma delta", OOLONG_ALIGN_LEFT, NULL);
+	oolong_layout_node_t* root = oolong_layout_node_create(&(oolong_layout_node_options_t){ .alignment = OOLONG_ALIGN_WIDTH });
+	oolong_layout_node_t* leaf = create_leaf(label, OOLONG_ALIGN_WIDTH);
+	oolong_layout_node_append(root, leaf);
+
+	for (size_t print = 0; print < 2; print++)
+	{
+		oolong_layout_print(root, file);
+		assert_box(leaf, 0, 0, 12, 2);
+		assert_row(terminal, 0, L"alpha beta  ");
+		assert_row(terminal, 1, L"gamma delta ");
+	}
+
+	oolong_layout_node_destroy(root);
+	oolong_label_destroy(label);
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
+
+SCRUTINY_UNIT_TEST layout_layer_stack_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(30, 8);
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(30, 8);
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+
+	wchar_t* contents[] = { L"row 1", L"row 2", L"row 3", L"row 4", L"row 5", L"row 6" };
+	oolong_label_t* rows[6];
+	oolong_layout_node_t* table = oolong_layout_node_create(&(oolong_layout_node_options_t){ 0 });
+
+	for (size_t index = 0; index < 6; index++)
+	{
+		rows[index] = create_label(contents[index], OOLONG_ALIGN_LEFT, NULL);
+		oolong_layout_node_append(table, create_leaf(rows[index], OOLONG_ALIGN_LEFT));
+	}
+
+	oolong_label_t* question = create_label(L"confirm?", OOLONG_ALIGN_LEFT, NULL);
+	oolong_layout_node_t* dialog = oolong_layout_node_create(&(oolong_layout_node_options_t){ .min_width = 16, .min_height = 3, .margin_top = 2 });
+	oolong_layout_node_append(dialog, create_leaf(question, OOLONG_ALIGN_LEFT));
+
+	oolong_layer_stack_t* stack = oolong_layer_stack_create();
+	oolong_layer_stack_push(stack, table, false);
+	oolong_layer_stack_print(stack, file);
+	scrutiny_assert_equal_size_t(6, oolong_layer_stack_get_lines_composed(stack));
+
+	/* Opening the dialog composes only it, the rows beneath it are hidden. */
+	oolong_layer_stack_push(stack, dialog, true);
+	oolong_layer_stack_print(stack, file);
+	scrutiny_assert_equal_size_t(1, oolong_layer_stack_get_lines_composed(stack));
+	scrutiny_assert_equal_size_t(3, oolong_layer_stack_get_lines_occluded(stack));
+
+	assert_row(terminal, 1, L"row 2                         ");
+	assert_row(terminal, 2, L"confirm?                      ");
+	assert_row(terminal, 3, L"                              ");
+	assert_row(terminal, 4, L"                              ");
+	assert_row(terminal, 5, L"row 6                         ");
+
+	/* A change beneath the dialog is not drawn over it. */
+	oolong_element_set_content((oolong_element_t*)rows[3], L"ROW 4");
+	oolong_layer_stack_print(stack, file);
+	scrutiny_assert_equal_size_t(0, oolong_layer_stack_get_lines_composed(stack));
+	assert_row(terminal, 3, L"                              ");
+
+	/* Closing it draws again only the rows it covered. */
+	oolong_layer_stack_remove(stack, dialog);
+	oolong_layer_stack_print(stack, file);
+	scrutiny_assert_equal_size_t(3, oolong_layer_stack_get_lines_composed(stack));
+
+	assert_row(terminal, 2, L"row 3                         ");
+	assert_row(terminal, 3, L"ROW 4                         ");
+	assert_row(terminal, 4, L"row 5                         ");
+
+	oolong_layer_stack_destroy(stack);
+	oolong_layout_node_destroy(dialog);
+	oolong_layout_node_destroy(table);
+	oolong_label_destroy(question);
+
+	for (size_t index = 0; index < 6; index++)
+		oolong_label_destroy(rows[index]);
+
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
+
+SCRUTINY_UNIT_TEST layout_split_panes_test(void)
+{
+	oolong_set_locale();
+	oolong_set_screen_dimensions(40, 6);
+
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(40, 6);
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+
+	oolong_layout_node_t* split = oolong_layout_node_create(&(oolong_layout_node_options_t){ .direction = OOLONG_LAYOUT_HORIZONTAL, .alignment = OOLONG_ALIGN_WIDTH, .gap = 1 });
+	oolong_layout_node_t* panes[3];
+	unsigned int weights[] = { 1, 2, 1 };
+
+	for (size_t index = 0; index < 3; index++)
+	{
+		panes[index] = oolong_layout_node_create(&(oolong_layout_node_options_t){ .weight = weights[index], .min_height = 4, .max_height = 4 });
+		oolong_layout_node_append(split, panes[index]);
+	}
+
+	wchar_t* contents[] = { L"log 1", L"log 2", L"log 3", L"log 4", L"log 5", L"log 6" };
+	oolong_label_t* item = create_label(L"item", OOLONG_ALIGN_LEFT, NULL);
+	oolong_label_t* detail = create_label(L"detail", OOLONG_ALIGN_LEFT, NULL);
+	oolong_label_t* logs[6];
+	oolong_layout_node_t* log_leaves[6];
+
+	oolong_layout_node_append(panes[0], create_leaf(item, OOLONG_ALIGN_LEFT));
+	oolong_layout_node_t* detail_leaf = create_leaf(detail, OOLONG_ALIGN_LEFT);
+	oolong_layout_node_append(panes[1], detail_leaf);
+
+	for (size_t index = 0; index < 6; index++)
+	{
+		logs[index] = create_label(contents[index], OOLONG_ALIGN_LEFT, NULL);
+		log_leaves[index] = create_leaf(logs[index], OOLONG_ALIGN_LEFT);
+		oolong_layout_node_append(panes[2], log_leaves[index]);
+	}
+
+	oolong_layout_print(split, file);
+
+	/* The 38 columns left by the gaps are shared 1:2:1, the last pane taking the remainder. */
+	assert_box(panes[0], 0, 0, 9, 4);
+	assert_box(panes[1], 10, 0, 19, 4);
+	assert_box(panes[2], 30, 0, 10, 4);
+
+	/* The log is clipped to its pane rather than drawn past it. */
+	assert_row(terminal, 0, L"item      detail              log 1     ");
+	assert_row(terminal, 3, L"                              log 4     ");
+	assert_row(terminal, 4, L"                                        ");
+
+	/* Scrolling the log moves its lines up within the pane, hiding the first two. */
+	oolong_layout_node_set_scroll(panes[2], 2);
+	oolong_layout_print(split, file);
+
+	scrutiny_assert_equal_unsigned_int(0, oolong_layout_node_get_visible_box(log_leaves[0]).height);
+	scrutiny_assert_equal_unsigned_int(0, oolong_layout_node_get_visible_box(log_leaves[2]).row);
+	assert_row(terminal, 0, L"item      detail              log 3     ");
+	assert_row(terminal, 3, L"                              log 6     ");
+	assert_row(terminal, 4, L"                                        ");
+
+	/* A change in one pane only touches that pane's cells, erasing the label's grown box and drawing it. */
+	oolong_element_set_content((oolong_element_t*)detail, L"changed");
+	oolong_layout_node_mark_dirty(detail_leaf);
+	oolong_virtual_terminal_reset_stats(terminal);
+	oolong_layout_print(split, file);
+
+	scrutiny_assert_equal_size_t(2 * 7, oolong_virtual_terminal_get_stats(terminal).cells_touched);
+	assert_row(terminal, 0, L"item      changed             log 3     ");
+
+	/* Resizing a pane moves the panes beside it. */
+	oolong_layout_node_set_weight(panes[0], 2);
+	oolong_layout_print(split, file);
+
+	assert_box(panes[0], 0, 0, 15, 4);
+	assert_box(panes[1], 16, 0, 15, 4);
+	assert_box(panes[2], 32, 0, 8, 4);
+	assert_row(terminal, 0, L"item            changed         log 3   ");
+
+	oolong_layout_node_destroy(split);
+	oolong_label_destroy(item);
+	oolong_label_destroy(detail);
+
+	for (size_t index = 0; index < 6; index++)
+		oolong_label_destroy(logs[index]);
+
+	oolong_virtual_terminal_destroy(terminal);
+	oolong_set_screen_dimensions(0, 0);
+}
@@ -0,0 +1,19 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef LAYOUT_TESTS_H
+#define LAYOUT_TESTS_H
+
+#include "include/scrutiny.h"
+
+SCRUTINY_UNIT_TEST layout_boxes_test(void);
+SCRUTINY_UNIT_TEST layout_incremental_test(void);
+SCRUTINY_UNIT_TEST layout_damage_test(void);
+SCRUTINY_UNIT_TEST layout_offscreen_test(void);
+SCRUTINY_UNIT_TEST layout_wrapped_fill_test(void);
+SCRUTINY_UNIT_TEST layout_layer_stack_test(void);
+SCRUTINY_UNIT_TEST layout_split_panes_test(void);
+
+#endif // LAYOUT_TESTS_H
@@ -10,20 +10,71 @@
 #include "keyboard_tests.h"
 #include "element_tests.h"
 #include "text_box_tests.h"
+#include "width_tests.h"
+#include "grapheme_tests.h"
+#include "wrap_tests.h"
+#include "virtual_terminal_tests.h"
+#include "frame_tests.h"
+#include "latency_tests.h"
+#include "capture_tests.h"
+#include "grid_view_tests.h"
+#include "layout_tests.h"
+#include "memory_tests.h"
+#include "arena_tests.h"
 
 int main()
 {
     scrutiny_unit_test_t unit_tests[] =
     {
         error_test,
+        error_last_record_test,
+        error_thread_local_test,
         style_set_add_test,
         buffered_keys_test,
+        keyboard_record_replay_test,
         element_selected_index_test,
         element_selected_identifier_test,
         element_render_test,
+        element_render_parallel_test,
+        element_render_wide_test,
+        element_content_slice_test,
+        element_render_reuse_test,
+        element_inline_string_test,
+        element_compose_narrow_test,
         element_select_next_test,
         element_select_previous_test,
         text_box_register_key_test,
+        text_box_backspace_cluster_test,
+        width_of_char_test,
+        width_of_string_test,
+        grapheme_boundary_test,
+        grapheme_cache_test,
+        wrap_words_test,
+        wrap_incremental_test,
+        virtual_terminal_escapes_test,
+        virtual_terminal_stack_view_test,
+        grid_view_layout_test,
+        grid_view_incremental_test,
+        layout_boxes_test,
+        layout_incremental_test,
+        layout_damage_test,
+        layout_offscreen_test,
+        layout_wrapped_fill_test,
+        layout_layer_stack_test,
+        layout_split_panes_test,
+        frame_stats_test,
+        frame_history_test,
+        frame_steady_state_allocations_test,
+        frame_render_direct_test,
+        frame_present_rows_test,
+        frame_present_rows_full_screen_test,
+        frame_present_rows_scroll_test,
+        latency_percentile_test,
+        latency_input_to_frame_test,
+        capture_asciicast_test,
+        memory_allocator_test,
+        arena_allocation_test,
+        arena_elements_test,
         NULL
     };
 
@@ -0,0 +1,54 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include "memory_tests.h"
+#include "test_helpers.h"
+#include "../oolong/oolong.h"
+
+SCRUTINY_UNIT_TEST memory_allocator_test(void)
+{
+	oolong_set_locale();
+
+	struct tracking_s tracking = { 0 };
+	oolong_allocator_t allocator =
+	{
+		.allocate = tracking_allocate,
+		.reallocate = tracking_reallocate,
+		.free = tracking_free,
+		.user = &tracking
+	};
+
+	oolong_error_set_exit_on_error(false);
+	scrutiny_assert_equal_enum(OOLONG_ERROR_INVALID_ARGUMENT, oolong_memory_set_allocator(&(oolong_allocator_t){ .allocate = tracking_allocate }));
+	oolong_error_set_exit_on_error(true);
+
+	oolong_memory_set_allocator(&allocator);
+
+	oolong_style_set_t* style = oolong_style_set_create();
+	oolong_style_set_add(&style, OOLONG_STYLE_BOLD);
+
+	oolong_text_box_options_t options =
+	{
+		.display_text = L"",
+		.state = OOLONG_ELEMENT_STATE_ACTIVE,
+		.style_normal = style,
+		.alignment = OOLONG_ALIGN_LEFT
+	};
+
+	oolong_text_box_t* text_box = oolong_text_box_create(&options);
+	oolong_text_box_insert_text(text_box, L"every allocation goes through the allocator");
+	oolong_text_box_register_keystroke(text_box, KEY_BACKSPACE);
+	oolong_element_render_string((oolong_element_t*)text_box);
+	oolong_element_get_wrap((oolong_element_t*)text_box, 10);
+
+	scrutiny_assert_true(tracking.allocations >= 6);
+	scrutiny_assert_true(tracking.live > 0);
+
+	/* Destroying gives everything back. */
+	oolong_text_box_destroy(text_box);
+	scrutiny_assert_equal_size_t(0, tracking.live);
+
+	oolong_memory_set_allocator(NULL);
+}
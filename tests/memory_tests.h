@@ -0,0 +1,13 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef MEMORY_TESTS_H
+#define MEMORY_TESTS_H
+
+#include "include/scrutiny.h"
+
+SCRUTINY_UNIT_TEST memory_allocator_test(void);
+
+#endif // MEMORY_TESTS_H
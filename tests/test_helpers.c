@@ -0,0 +1,50 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <stdlib.h>
+#include "test_helpers.h"
+
+void* tracking_allocate(void* user, size_t size)
+{
+	struct tracking_s* tracking = user;
+	tracking->allocations++;
+	tracking->live++;
+	return malloc(size);
+}
+
+void* tracking_reallocate(void* user, void* pointer, size_t size)
+{
+	struct tracking_s* tracking = user;
+	tracking->allocations++;
+	tracking->live += pointer == NULL;
+	return realloc(pointer, size);
+}
+
+void tracking_free(void* user, void* pointer)
+{
+	struct tracking_s* tracking = user;
+	tracking->live -= pointer != NULL;
+	free(pointer);
+}
+
+oolong_label_t* create_label(wchar_t* content, oolong_alignment_t alignment, oolong_style_set_t* style)
+{
+	oolong_label_options_t options =
+	{
+		.alignment = alignment,
+		.style = style,
+		.content = content
+	};
+
+	return oolong_label_create(&options);
+}
+
+void assert_row(oolong_virtual_terminal_t* terminal, unsigned int row, wchar_t* expected)
+{
+	wchar_t buffer[128];
+	size_t length = oolong_virtual_terminal_read_row(terminal, row, buffer);
+	scrutiny_assert_equal_size_t(wcslen(expected), length);
+	scrutiny_assert_equal_array(expected, buffer, sizeof(wchar_t), length);
+}
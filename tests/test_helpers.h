@@ -0,0 +1,40 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+#include <stddef.h>
+#include <wchar.h>
+#include "include/scrutiny.h"
+#include "../oolong/oolong.h"
+
+/*
+ * Counts what is allocated through the tracking allocator, set with
+ * oolong_memory_set_allocator() and the counts as its user pointer, for
+ * checking that everything allocated is given back.
+ */
+struct tracking_s
+{
+	size_t allocations;		/* Calls to allocate or reallocate. */
+	size_t live;			/* Allocations not yet freed. */
+};
+
+void* tracking_allocate(void* user, size_t size);
+void* tracking_reallocate(void* user, void* pointer, size_t size);
+void tracking_free(void* user, void* pointer);
+
+/*
+ * Creates a label with the given content, alignment, and style, which the label
+ * takes and may be NULL.
+ */
+oolong_label_t* create_label(wchar_t* content, oolong_alignment_t alignment, oolong_style_set_t* style);
+
+/*
+ * Asserts that a row of the virtual terminal reads back as the expected string.
+ */
+void assert_row(oolong_virtual_terminal_t* terminal, unsigned int row, wchar_t* expected);
+
+#endif // TEST_HELPERS_H
@@ -39,3 +39,34 @@ SCRUTINY_UNIT_TEST text_box_register_key_test(void)
 	oolong_text_box_destroy(text_box);
 }
 
+
+SCRUTINY_UNIT_TEST text_box_backspace_cluster_test(void)
+{
+	oolong_text_box_options_t options = 
+	{
+		.display_text = L"",
+		.state = OOLONG_ELEMENT_STATE_ACTIVE,
+		.style_normal = oolong_style_set_create(),
+		.alignment = OOLONG_ALIGN_LEFT
+	};
+	
+	oolong_text_box_t* text_box = oolong_text_box_create(&options);
+
+	oolong_text_box_register_keystroke(text_box, KEY_LOWERCASE_A);
+	oolong_text_box_insert_text(text_box, L"e\u0301");
+	oolong_text_box_insert_text(text_box, L"\U0001f468\u200d\U0001f469");
+	scrutiny_assert_equal_size_t(6, wcslen(oolong_text_box_get_entered_text(text_box)));
+
+	/* Each backspace removes a whole cluster. */
+	oolong_text_box_register_keystroke(text_box, KEY_BACKSPACE);
+	scrutiny_assert_equal_array(L"ae\u0301", oolong_text_box_get_entered_text(text_box), sizeof(wchar_t), 4);
+
+	oolong_text_box_register_keystroke(text_box, KEY_BACKSPACE);
+	scrutiny_assert_equal_array(L"a", oolong_text_box_get_entered_text(text_box), sizeof(wchar_t), 2);
+
+	oolong_text_box_register_keystroke(text_box, KEY_BACKSPACE);
+	oolong_text_box_register_keystroke(text_box, KEY_BACKSPACE);
+	scrutiny_assert_equal_array(L"", oolong_text_box_get_entered_text(text_box), sizeof(wchar_t), 1);
+
+	oolong_text_box_destroy(text_box);
+}
@@ -9,6 +9,7 @@
 #include "include/scrutiny.h"
 
 SCRUTINY_UNIT_TEST text_box_register_key_test(void);
+SCRUTINY_UNIT_TEST text_box_backspace_cluster_test(void);
 
 #endif // TEXT_BOX_TESTS_H
 
@@ -0,0 +1,126 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <string.h>
+#include "virtual_terminal_tests.h"
+#include "test_helpers.h"
+#include "../oolong/oolong.h"
+#include "../oolong/virtual_terminal.h"
+
+static void write_string(oolong_virtual_terminal_t* terminal, char* bytes)
+{
+	oolong_virtual_terminal_write(terminal, bytes, strlen(bytes));
+}
+
+SCRUTINY_UNIT_TEST virtual_terminal_escapes_test(void)
+{
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(8, 3);
+	unsigned int column, row;
+
+	write_string(terminal, "ab\e[2;4Hc\e[1;31md");
+	assert_row(terminal, 0, L"ab      ");
+	assert_row(terminal, 1, L"   cd   ");
+	scrutiny_assert_equal_int(1, oolong_virtual_terminal_get_cell(terminal, 4, 1)->foreground);
+	scrutiny_assert_equal_int(OOLONG_VIRTUAL_ATTRIBUTE_BOLD, oolong_virtual_terminal_get_cell(terminal, 4, 1)->attributes);
+	scrutiny_assert_equal_int(-1, oolong_virtual_terminal_get_cell(terminal, 3, 1)->foreground);
+
+	/* Wide characters take two cells and only appear once when read back. */
+	write_string(terminal, "\e[0m\e[3;1H\xe4\xb8\xad!");
+	assert_row(terminal, 2, L"\u4e2d!     ");
+	oolong_virtual_terminal_get_cursor(terminal, &column, &row);
+	scrutiny_assert_equal_uint32_t(3, column);
+	scrutiny_assert_equal_uint32_t(2, row);
+
+	/* A newline on the last row scrolls, erasing a line clears it. */
+	oolong_virtual_terminal_reset_stats(terminal);
+	write_string(terminal, "\nxyz\e[1;1H\e[K");
+	assert_row(terminal, 0, L"        ");
+	assert_row(terminal, 1, L"\u4e2d!     ");
+	assert_row(terminal, 2, L"xyz     ");
+
+	oolong_virtual_terminal_stats_t stats = oolong_virtual_terminal_get_stats(terminal);
+	scrutiny_assert_equal_size_t(13, stats.bytes);
+	scrutiny_assert_equal_size_t(3, stats.characters);
+	scrutiny_assert_equal_size_t(2, stats.escapes);
+	scrutiny_assert_equal_size_t(1, stats.lines_scrolled);
+	scrutiny_assert_equal_size_t(8 + 3 + 8, stats.cells_touched);
+
+	/* The file is buffered but flushed before the terminal is read. */
+	fputs("\e[1;1Hok", oolong_virtual_terminal_get_file(terminal));
+	assert_row(terminal, 0, L"ok      ");
+
+	oolong_virtual_terminal_destroy(terminal);
+
+	/* A wide character too wide for the whole screen is replaced rather than overflowing it. */
+	terminal = oolong_virtual_terminal_create(1, 1);
+	write_string(terminal, "\xe4\xb8\xad");
+	assert_row(terminal, 0, L"\ufffd");
+	oolong_virtual_terminal_destroy(terminal);
+}
+
+SCRUTINY_UNIT_TEST virtual_terminal_stack_view_test(void)
+{
+	oolong_set_locale();
+	oolong_virtual_terminal_t* terminal = oolong_virtual_terminal_create(20, 6);
+	oolong_set_screen_dimensions(20, 6);
+
+	oolong_label_options_t centered_options =
+	{
+		.identifier = 0,
+		.alignment = OOLONG_ALIGN_CENTER,
+		.padding = 0,
+		.width = 0,
+		.style = oolong_style_set_create(),
+		.content = L"centered"
+	};
+
+	oolong_label_options_t wrapped_options =
+	{
+		.identifier = 1,
+		.alignment = OOLONG_ALIGN_LEFT,
+		.padding = 0,
+		.width = 0,
+		.style = oolong_style_set_create(),
+		.content = L"the quick brown fox jumps over"
+	};
+
+	oolong_label_t* centered = oolong_label_create(&centered_options);
+	oolong_label_t* wrapped = oolong_label_create(&wrapped_options);
+
+	oolong_stack_view_t center_view =
+	{
+		.elements = (oolong_element_t*[]){ (oolong_element_t*)centered, NULL },
+		.alignment = OOLONG_ALIGN_CENTER
+	};
+
+	oolong_stack_view_t left_view =
+	{
+		.elements = (oolong_element_t*[]){ (oolong_element_t*)wrapped, NULL },
+		.alignment = OOLONG_ALIGN_LEFT,
+		.margin_sides = 2
+	};
+
+	FILE* file = oolong_virtual_terminal_get_file(terminal);
+
+	oolong_stack_view_print(&center_view, file);
+	assert_row(terminal, 0, L"      centered      ");
+
+	/* Right alignment keeps the view's margin on the right. */
+	center_view.alignment = OOLONG_ALIGN_RIGHT;
+	center_view.margin_sides = 1;
+	oolong_virtual_terminal_reset(terminal);
+	oolong_stack_view_print(&center_view, file);
+	assert_row(terminal, 0, L"           centered ");
+
+	oolong_virtual_terminal_reset(terminal);
+	oolong_stack_view_print(&left_view, file);
+	assert_row(terminal, 0, L"  the quick brown   ");
+	assert_row(terminal, 1, L"  fox jumps over    ");
+
+	oolong_set_screen_dimensions(0, 0);
+	oolong_label_destroy(centered);
+	oolong_label_destroy(wrapped);
+	oolong_virtual_terminal_destroy(terminal);
+}
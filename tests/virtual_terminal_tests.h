@@ -0,0 +1,14 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef VIRTUAL_TERMINAL_TESTS_H
+#define VIRTUAL_TERMINAL_TESTS_H
+
+#include "include/scrutiny.h"
+
+SCRUTINY_UNIT_TEST virtual_terminal_escapes_test(void);
+SCRUTINY_UNIT_TEST virtual_terminal_stack_view_test(void);
+
+#endif // VIRTUAL_TERMINAL_TESTS_H
@@ -0,0 +1,46 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include "width_tests.h"
+#include "../oolong/width.h"
+
+SCRUTINY_UNIT_TEST width_of_char_test(void)
+{
+	scrutiny_assert_equal_unsigned_int(1, oolong_width_of_char(L'a'));
+	scrutiny_assert_equal_unsigned_int(1, oolong_width_of_char(L'~'));
+	scrutiny_assert_equal_unsigned_int(1, oolong_width_of_char(L'\u00e9'));	/* Precomposed e acute. */
+	scrutiny_assert_equal_unsigned_int(0, oolong_width_of_char(L'\n'));
+	scrutiny_assert_equal_unsigned_int(0, oolong_width_of_char(L'\033'));
+	scrutiny_assert_equal_unsigned_int(0, oolong_width_of_char(L'\u0301'));	/* Combining acute accent. */
+	scrutiny_assert_equal_unsigned_int(0, oolong_width_of_char(L'\u200d'));	/* Zero width joiner. */
+	scrutiny_assert_equal_unsigned_int(0, oolong_width_of_char(L'\ufe0f'));	/* Variation selector 16. */
+	scrutiny_assert_equal_unsigned_int(2, oolong_width_of_char(L'\u4e2d'));	/* CJK ideograph. */
+	scrutiny_assert_equal_unsigned_int(2, oolong_width_of_char(L'\uac00'));	/* Hangul syllable. */
+	scrutiny_assert_equal_unsigned_int(2, oolong_width_of_char(L'\uff21'));	/* Fullwidth A. */
+	scrutiny_assert_equal_unsigned_int(2, oolong_width_of_char(L'\U0001f600'));	/* Grinning face. */
+	scrutiny_assert_equal_unsigned_int(1, oolong_width_of_char(L'\U0001f100'));
+}
+
+SCRUTINY_UNIT_TEST width_of_string_test(void)
+{
+	scrutiny_assert_equal_size_t(0, oolong_width_of_string(L"", 0));
+	scrutiny_assert_equal_size_t(0, oolong_width_of_string(NULL, 4));
+
+	/* Long enough to take the vectorised path with a scalar tail. */
+	wchar_t* ascii = L"the quick brown fox jumps over the lazy dog";
+	scrutiny_assert_equal_size_t(wcslen(ascii), oolong_width_of_string(ascii, wcslen(ascii)));
+
+	/* 
+	 * Non ASCII characters both inside and after vector sized blocks, the two
+	 * ideographs and the emoji each take an extra column while the combining
+	 * accent takes none.
+	 */
+
+	wchar_t* mixed = L"host-\u4e2d\u6587-name.example.org e\u0301 \U0001f600";
+	scrutiny_assert_equal_size_t(wcslen(mixed) + 3 - 1, oolong_width_of_string(mixed, wcslen(mixed)));
+
+	/* Only the given length is measured. */
+	scrutiny_assert_equal_size_t(4, oolong_width_of_string(L"\u4e2d\u6587abc", 2));
+}
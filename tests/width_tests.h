@@ -0,0 +1,14 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef WIDTH_TESTS_H
+#define WIDTH_TESTS_H
+
+#include "include/scrutiny.h"
+
+SCRUTINY_UNIT_TEST width_of_char_test(void);
+SCRUTINY_UNIT_TEST width_of_string_test(void);
+
+#endif // WIDTH_TESTS_H
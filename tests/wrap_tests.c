@@ -0,0 +1,99 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#include <string.h>
+#include "wrap_tests.h"
+#include "../oolong/wrap.h"
+
+static void assert_line(oolong_wrap_t* wrap, size_t line, wchar_t* expected)
+{
+	oolong_wrap_line_t* wrap_line = oolong_wrap_get_line(wrap, line);
+	scrutiny_assert_equal_size_t(wcslen(expected), wrap_line->length);
+	scrutiny_assert_equal_array(expected, (void*)&wrap->source[wrap_line->start], sizeof(wchar_t), wrap_line->length);
+}
+
+SCRUTINY_UNIT_TEST wrap_words_test(void)
+{
+	oolong_graphemes_t graphemes = { 0 };
+	oolong_wrap_t wrap = { 0 };
+
+	wchar_t* words = L"the quick brown fox jumps";
+	oolong_graphemes_update(&graphemes, words, wcslen(words));
+	oolong_wrap_update(&wrap, &graphemes, 10);
+	scrutiny_assert_equal_size_t(3, wrap.count);
+	assert_line(&wrap, 0, L"the quick");
+	assert_line(&wrap, 1, L"brown fox");
+	assert_line(&wrap, 2, L"jumps");
+
+	/* A word longer than a line is broken within. */
+	wchar_t* long_word = L"ab abcdefghijkl";
+	oolong_graphemes_update(&graphemes, long_word, wcslen(long_word));
+	oolong_wrap_update(&wrap, &graphemes, 5);
+	scrutiny_assert_equal_size_t(4, wrap.count);
+	assert_line(&wrap, 0, L"ab");
+	assert_line(&wrap, 1, L"abcde");
+	assert_line(&wrap, 3, L"kl");
+
+	/* Newlines always break and wide characters count as two columns. */
+	wchar_t* lines = L"one\n\u4e2d\u6587\u4e2d\u6587";
+	oolong_graphemes_update(&graphemes, lines, wcslen(lines));
+	oolong_wrap_update(&wrap, &graphemes, 5);
+	scrutiny_assert_equal_size_t(3, wrap.count);
+	assert_line(&wrap, 0, L"one");
+	assert_line(&wrap, 1, L"\u4e2d\u6587");
+	scrutiny_assert_equal_size_t(4, oolong_wrap_get_line(&wrap, 1)->width);
+
+	oolong_wrap_destroy(&wrap);
+	oolong_graphemes_destroy(&graphemes);
+}
+
+SCRUTINY_UNIT_TEST wrap_incremental_test(void)
+{
+	wchar_t* text = L"lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor";
+	size_t text_length = wcslen(text);
+	wchar_t edited[text_length + 1];
+
+	oolong_graphemes_t graphemes = { 0 };
+	oolong_graphemes_t fresh_graphemes = { 0 };
+	oolong_wrap_t wrap = { 0 };
+	oolong_wrap_t fresh_wrap = { 0 };
+	bool all_equal = true;
+
+	/* Typing the text one character at a time, as into a text box. */
+	for (size_t length = 0; length <= text_length; length++)
+	{
+		wmemcpy(edited, text, length);
+		edited[length] = L'\0';
+
+		oolong_graphemes_update(&graphemes, edited, length);
+		oolong_wrap_update(&wrap, &graphemes, 12);
+
+		oolong_graphemes_invalidate_from(&fresh_graphemes, 0);
+		oolong_wrap_invalidate_from(&fresh_wrap, 0);
+		oolong_graphemes_update(&fresh_graphemes, edited, length);
+		oolong_wrap_update(&fresh_wrap, &fresh_graphemes, 12);
+
+		all_equal = all_equal && wrap.count == fresh_wrap.count;
+		all_equal = all_equal && memcmp(wrap.lines, fresh_wrap.lines, wrap.count * sizeof *wrap.lines) == 0;
+	}
+
+	scrutiny_assert_true(all_equal);
+
+	/* Shortening a word at the start of a line lets it move up a line. */
+	wcscpy(edited, L"aaaa bbb cccccc");
+	oolong_graphemes_update(&graphemes, edited, wcslen(edited));
+	oolong_wrap_update(&wrap, &graphemes, 10);
+	scrutiny_assert_equal_size_t(2, wrap.count);
+
+	wcscpy(&edited[9], L"c");
+	oolong_graphemes_update(&graphemes, edited, wcslen(edited));
+	oolong_wrap_update(&wrap, &graphemes, 10);
+	scrutiny_assert_equal_size_t(1, wrap.count);
+
+	oolong_wrap_destroy(&wrap);
+	oolong_wrap_destroy(&fresh_wrap);
+	oolong_graphemes_destroy(&graphemes);
+	oolong_graphemes_destroy(&fresh_graphemes);
+}
@@ -0,0 +1,14 @@
+/* 
+ * Copyright (c) 2023 Evan Overman (https://an-prata.it). Licensed under the MIT License.
+ * See LICENSE file in repository root for complete license text.
+ */
+
+#ifndef WRAP_TESTS_H
+#define WRAP_TESTS_H
+
+#include "include/scrutiny.h"
+
+SCRUTINY_UNIT_TEST wrap_words_test(void);
+SCRUTINY_UNIT_TEST wrap_incremental_test(void);
+
+#endif // WRAP_TESTS_H